@@ -0,0 +1,642 @@
+// Microbenchmarks for the engine hot paths: rasterizer fills and lines,
+// the scalar fractal kernels, the Game of Life update and triangle
+// generation. Every case reseeds the global RNG so runs are comparable,
+// and results are written as JSON for tracking regressions over time.
+//
+//   bench_main [--filter SUBSTRING] [--min-time SECONDS] [--threads N]
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "utils.h"
+#include "pixelbuffer.h"
+#include "fractals.h"
+#include "fractal_kernels.h"
+#include "mariani_silver.h"
+#include "deep_zoom.h"
+#include "fast_math.h"
+#include "hsv_color.h"
+#include "fractal_system.h"
+#include "weird_entities.h"
+#include "raster_kernels.h"
+#include "thread_pool.h"
+
+namespace {
+
+constexpr uint64_t kSeed = 0x5EED5EEDull;
+constexpr int kCanvasWidth = 1920;
+constexpr int kCanvasHeight = 1080;
+
+struct BenchResult {
+    std::string name;
+    long long iterations;
+    double seconds;
+    // Work done per iteration; zero when the unit does not apply
+    double pixels;
+    double triangles;
+    double cells;
+};
+
+struct BenchOptions {
+    std::string filter;
+    double minTime = 0.25;
+    int threads = 0;
+};
+
+using Clock = std::chrono::steady_clock;
+
+// Runs body in doubling batches until minTime has elapsed (at least once)
+// and returns the iteration count and total time
+BenchResult runTimed(const std::string& name, double minTime, const std::function<void()>& body) {
+    BenchResult result{name, 0, 0.0, 0.0, 0.0, 0.0};
+    long long batch = 1;
+    while (true) {
+        auto start = Clock::now();
+        for (long long i = 0; i < batch; i++) {
+            body();
+        }
+        result.seconds += std::chrono::duration<double>(Clock::now() - start).count();
+        result.iterations += batch;
+        if (result.seconds >= minTime) break;
+        batch *= 2;
+    }
+    return result;
+}
+
+struct Triangle2D {
+    int x[3], y[3];
+    uint32_t colors[3];
+};
+
+// Random triangles whose vertices lie within size pixels of a random
+// anchor, so the average covered area grows with size squared
+std::vector<Triangle2D> makeTriangles(int size, int count) {
+    std::vector<Triangle2D> triangles(count);
+    for (auto& tri : triangles) {
+        int anchorX = randomInt(0, kCanvasWidth - size - 1);
+        int anchorY = randomInt(0, kCanvasHeight - size - 1);
+        for (int i = 0; i < 3; i++) {
+            tri.x[i] = anchorX + randomInt(0, size);
+            tri.y[i] = anchorY + randomInt(0, size);
+            tri.colors[i] = randomColor();
+        }
+    }
+    return triangles;
+}
+
+double triangleArea(const Triangle2D& tri) {
+    double cross = (double)(tri.x[1] - tri.x[0]) * (tri.y[2] - tri.y[0]) -
+                   (double)(tri.x[2] - tri.x[0]) * (tri.y[1] - tri.y[0]);
+    return std::abs(cross) * 0.5;
+}
+
+double lineLength(int x0, int y0, int x1, int y1) {
+    return std::max(std::abs(x1 - x0), std::abs(y1 - y0)) + 1;
+}
+
+class BenchSuite {
+public:
+    explicit BenchSuite(const BenchOptions& options) : options(options) {}
+    
+    bool enabled(const std::string& name) const {
+        return options.filter.empty() || name.find(options.filter) != std::string::npos;
+    }
+    
+    void add(BenchResult result) {
+        std::fprintf(stderr, "%-48s %10lld iters %9.3f s\n", result.name.c_str(), result.iterations, result.seconds);
+        results.push_back(result);
+    }
+    
+    double minTime() const { return options.minTime; }
+    
+    void writeJson(FILE* out) const {
+        std::fprintf(out, "{\n  \"seed\": %llu,\n  \"raster_kernels\": \"%s\",\n  \"fractal_kernels\": \"%s\",\n"
+                          "  \"threads\": %zu,\n  \"benchmarks\": [\n",
+                     (unsigned long long)kSeed, rasterKernels().name, fractalKernels().name,
+                     globalThreadPool().getWorkerCount());
+        for (size_t i = 0; i < results.size(); i++) {
+            const BenchResult& r = results[i];
+            double perIteration = r.seconds / r.iterations;
+            std::fprintf(out, "    {\"name\": \"%s\", \"iterations\": %lld, \"seconds\": %.6f, \"ns_per_iteration\": %.1f",
+                         r.name.c_str(), r.iterations, r.seconds, perIteration * 1e9);
+            if (r.pixels > 0) {
+                std::fprintf(out, ", \"ns_per_pixel\": %.4f", perIteration * 1e9 / r.pixels);
+            }
+            if (r.triangles > 0) {
+                std::fprintf(out, ", \"triangles_per_second\": %.1f", r.triangles / perIteration);
+            }
+            if (r.cells > 0) {
+                std::fprintf(out, ", \"cells_per_second\": %.1f", r.cells / perIteration);
+            }
+            std::fprintf(out, "}%s\n", i + 1 < results.size() ? "," : "");
+        }
+        std::fprintf(out, "  ]\n}\n");
+    }
+    
+private:
+    BenchOptions options;
+    std::vector<BenchResult> results;
+};
+
+// ============================================================================
+// Rasterizer
+// ============================================================================
+
+void benchRasterizer(BenchSuite& suite) {
+    static const int kSizes[] = {4, 16, 64, 256, 1024};
+    const int kCount = 256;
+    PixelBuffer buffer(kCanvasWidth, kCanvasHeight);
+    
+    using TriangleFill = std::function<void(PixelBuffer&, const Triangle2D&)>;
+    struct FillCase { const char* name; TriangleFill draw; bool outline; };
+    const FillCase fills[] = {
+        {"fillTriangle", [](PixelBuffer& pb, const Triangle2D& t) {
+            pb.fillTriangle(t.x[0], t.y[0], t.x[1], t.y[1], t.x[2], t.y[2], t.colors[0]); }, false},
+        {"fillTriangleBarycentric", [](PixelBuffer& pb, const Triangle2D& t) {
+            pb.fillTriangleBarycentric(t.x[0], t.y[0], t.x[1], t.y[1], t.x[2], t.y[2], t.colors[0]); }, false},
+        {"fillTriangleGradient", [](PixelBuffer& pb, const Triangle2D& t) {
+            pb.fillTriangleGradient(t.x[0], t.y[0], t.colors[0], t.x[1], t.y[1], t.colors[1], t.x[2], t.y[2], t.colors[2]); }, false},
+        {"fillTriangleGradientScanline", [](PixelBuffer& pb, const Triangle2D& t) {
+            pb.fillTriangleGradientScanline(t.x[0], t.y[0], t.colors[0], t.x[1], t.y[1], t.colors[1], t.x[2], t.y[2], t.colors[2]); }, false},
+        {"fillTriangleRainbow", [](PixelBuffer& pb, const Triangle2D& t) {
+            pb.fillTriangleRainbow(t.x[0], t.y[0], t.x[1], t.y[1], t.x[2], t.y[2]); }, false},
+        {"drawTriangleWireframe", [](PixelBuffer& pb, const Triangle2D& t) {
+            pb.drawTriangleWireframe(t.x[0], t.y[0], t.x[1], t.y[1], t.x[2], t.y[2], t.colors[0], t.colors[1]); }, false},
+        {"drawTriangle", [](PixelBuffer& pb, const Triangle2D& t) {
+            pb.drawTriangle(t.x[0], t.y[0], t.x[1], t.y[1], t.x[2], t.y[2], t.colors[0]); }, true},
+    };
+    
+    for (const FillCase& fill : fills) {
+        for (int size : kSizes) {
+            std::string name = std::string("raster/") + fill.name + "/" + std::to_string(size);
+            if (!suite.enabled(name)) continue;
+            
+            rng.seed(kSeed);
+            std::vector<Triangle2D> triangles = makeTriangles(size, kCount);
+            double pixels = 0;
+            for (const auto& t : triangles) {
+                pixels += fill.outline ? lineLength(t.x[0], t.y[0], t.x[1], t.y[1]) +
+                                         lineLength(t.x[1], t.y[1], t.x[2], t.y[2]) +
+                                         lineLength(t.x[2], t.y[2], t.x[0], t.y[0])
+                                       : triangleArea(t);
+            }
+            
+            BenchResult result = runTimed(name, suite.minTime(), [&]() {
+                for (const auto& t : triangles) fill.draw(buffer, t);
+            });
+            result.pixels = pixels;
+            result.triangles = kCount;
+            suite.add(result);
+        }
+    }
+    
+    for (int size : kSizes) {
+        std::string name = "raster/drawLine/" + std::to_string(size);
+        if (!suite.enabled(name)) continue;
+        rng.seed(kSeed);
+        std::vector<Triangle2D> segments = makeTriangles(size, kCount);
+        double pixels = 0;
+        for (const auto& s : segments) pixels += lineLength(s.x[0], s.y[0], s.x[1], s.y[1]);
+        BenchResult result = runTimed(name, suite.minTime(), [&]() {
+            for (const auto& s : segments) buffer.drawLine(s.x[0], s.y[0], s.x[1], s.y[1], s.colors[0]);
+        });
+        result.pixels = pixels;
+        suite.add(result);
+    }
+    
+    for (int size : kSizes) {
+        std::string name = "raster/fillRectangle/" + std::to_string(size);
+        if (!suite.enabled(name)) continue;
+        rng.seed(kSeed);
+        std::vector<Triangle2D> rects = makeTriangles(size, kCount);
+        // Only the part inside the canvas gets filled; large rects are mostly clipped
+        double pixels = 0;
+        for (const auto& r : rects) {
+            int w = std::min(kCanvasWidth, r.x[0] + size) - std::max(0, r.x[0]);
+            int h = std::min(kCanvasHeight, r.y[0] + size) - std::max(0, r.y[0]);
+            if (w > 0 && h > 0) pixels += (double)w * h;
+        }
+        BenchResult result = runTimed(name, suite.minTime(), [&]() {
+            for (const auto& r : rects) buffer.fillRectangle(r.x[0], r.y[0], size, size, r.colors[0]);
+        });
+        result.pixels = pixels;
+        suite.add(result);
+    }
+    
+    {
+        std::string name = "raster/clear";
+        if (suite.enabled(name)) {
+            BenchResult result = runTimed(name, suite.minTime(), [&]() { buffer.clear(0xFF102030); });
+            result.pixels = (double)kCanvasWidth * kCanvasHeight;
+            suite.add(result);
+        }
+    }
+}
+
+// ============================================================================
+// Fractal kernels
+// ============================================================================
+
+void benchFractals(BenchSuite& suite) {
+    const int kGridWidth = 256, kGridHeight = 256;
+    struct FractalCase { const char* name; float (*compute)(float, float); };
+    const FractalCase cases[] = {
+        {"computeMandelbrot", computeMandelbrot},
+        {"computeJulia", [](float x, float y) { return computeJulia(x, y, -0.7f, 0.27015f); }},
+        {"computeBurningShip", computeBurningShip},
+        {"computeTricorn", computeTricorn},
+        {"computePhoenix", computePhoenix},
+        {"computeNova", computeNova},
+        {"computePsychedelicWaves", computePsychedelicWaves},
+        {"computeStrangeAttractor", computeStrangeAttractor},
+        {"computeChaosFractal", computeChaosFractal},
+    };
+    
+    for (const FractalCase& fractal : cases) {
+        std::string name = std::string("fractal/") + fractal.name;
+        if (!suite.enabled(name)) continue;
+        volatile float sink = 0;
+        BenchResult result = runTimed(name, suite.minTime(), [&]() {
+            float sum = 0;
+            for (int y = 0; y < kGridHeight; y++) {
+                float fy = -1.5f + 3.0f * y / kGridHeight;
+                for (int x = 0; x < kGridWidth; x++) {
+                    sum += fractal.compute(-2.0f + 3.0f * x / kGridWidth, fy);
+                }
+            }
+            sink = sink + sum;
+        });
+        result.cells = (double)kGridWidth * kGridHeight;
+        suite.add(result);
+    }
+    
+    // Row batch kernels over the same grid
+    using RowKernel = std::function<void(const float*, const float*, float*, int)>;
+    struct RowCase { const char* name; RowKernel compute; };
+    const RowCase rowCases[] = {
+        {"computeMandelbrotRow", [](const float* xs, const float* ys, float* out, int count) {
+            computeMandelbrotRow(xs, ys, out, count); }},
+        {"computeJuliaRow", [](const float* xs, const float* ys, float* out, int count) {
+            computeJuliaRow(xs, ys, out, count, -0.7f, 0.27015f); }},
+        {"computeBurningShipRow", [](const float* xs, const float* ys, float* out, int count) {
+            computeBurningShipRow(xs, ys, out, count); }},
+        {"computeTricornRow", [](const float* xs, const float* ys, float* out, int count) {
+            computeTricornRow(xs, ys, out, count); }},
+        {"computePhoenixRow", [](const float* xs, const float* ys, float* out, int count) {
+            computePhoenixRow(xs, ys, out, count); }},
+    };
+    std::vector<float> xs(kGridWidth), ys(kGridWidth), out(kGridWidth);
+    for (int x = 0; x < kGridWidth; x++) xs[x] = -2.0f + 3.0f * x / kGridWidth;
+    
+    for (const RowCase& row : rowCases) {
+        std::string name = std::string("fractal/") + row.name;
+        if (!suite.enabled(name)) continue;
+        volatile float sink = 0;
+        BenchResult result = runTimed(name, suite.minTime(), [&]() {
+            for (int y = 0; y < kGridHeight; y++) {
+                std::fill(ys.begin(), ys.end(), -1.5f + 3.0f * y / kGridHeight);
+                row.compute(xs.data(), ys.data(), out.data(), kGridWidth);
+                sink = sink + out[y];
+            }
+        });
+        result.cells = (double)kGridWidth * kGridHeight;
+        suite.add(result);
+    }
+    
+    // Interior-heavy Mandelbrot view (mostly main cardioid) with and without
+    // the early exits, at the default and a 10x iteration limit
+    for (int maxIterations : {25, 250}) {
+        for (bool checks : {false, true}) {
+            std::string name = "fractal/computeMandelbrotRow/interior/" + std::to_string(maxIterations) +
+                               (checks ? "/checks" : "/nochecks");
+            if (!suite.enabled(name)) continue;
+            EscapeTimeOptions options = { maxIterations, checks, checks };
+            std::vector<float> interiorXs(kGridWidth);
+            for (int x = 0; x < kGridWidth; x++) interiorXs[x] = -0.5f + 0.6f * x / kGridWidth;
+            volatile float sink = 0;
+            BenchResult result = runTimed(name, suite.minTime(), [&]() {
+                for (int y = 0; y < kGridHeight; y++) {
+                    std::fill(ys.begin(), ys.end(), -0.3f + 0.6f * y / kGridHeight);
+                    computeMandelbrotRow(interiorXs.data(), ys.data(), out.data(), kGridWidth, options);
+                    sink = sink + out[y];
+                }
+            });
+            result.cells = (double)kGridWidth * kGridHeight;
+            suite.add(result);
+        }
+    }
+}
+
+// ============================================================================
+// Mariani-Silver renderer
+// ============================================================================
+
+void benchMarianiSilver(BenchSuite& suite) {
+    const int kWidth = 1920, kHeight = 1080;
+    std::vector<float> image((size_t)kWidth * kHeight);
+    
+    // Mariani-Silver pays off where uniform regions are expensive, so the
+    // interior shortcuts are off in the nochecks cases to show the crossover
+    struct ViewCase { const char* name; EscapeFractal fractal; float centerX, centerY, extent; bool checks; };
+    const ViewCase views[] = {
+        {"mandelbrot/full", EscapeFractal::Mandelbrot, -0.6f, 0.0f, 3.2f, true},
+        {"mandelbrot/full/nochecks", EscapeFractal::Mandelbrot, -0.6f, 0.0f, 3.2f, false},
+        {"mandelbrot/seahorse", EscapeFractal::Mandelbrot, -0.745f, 0.11f, 0.02f, true},
+        {"julia/full", EscapeFractal::Julia, 0.0f, 0.0f, 3.2f, true},
+        {"julia/full/nochecks", EscapeFractal::Julia, 0.0f, 0.0f, 3.2f, false},
+    };
+    
+    for (const ViewCase& viewCase : views) {
+        EscapeTimeView view;
+        view.fractal = viewCase.fractal;
+        view.options = defaultEscapeTimeOptions(viewCase.fractal);
+        view.options.maxIterations = 250;
+        if (!viewCase.checks) {
+            view.options.interiorTest = false;
+            view.options.periodicityCheck = false;
+        }
+        view.juliaX = -0.7f;
+        view.juliaY = 0.27015f;
+        view.stepX = view.stepY = viewCase.extent / kWidth;
+        view.originX = viewCase.centerX - viewCase.extent * 0.5f;
+        view.originY = viewCase.centerY - view.stepY * kHeight * 0.5f;
+        
+        std::string name = std::string("mariani_silver/") + viewCase.name;
+        if (suite.enabled(name)) {
+            MarianiSilverRenderer renderer;
+            BenchResult result = runTimed(name, suite.minTime(), [&]() {
+                renderer.begin(kWidth, kHeight, view, image.data(), true);
+                renderer.renderAll();
+            });
+            result.pixels = (double)kWidth * kHeight;
+            suite.add(result);
+        }
+        
+        // Every pixel through the batch kernels, for comparison
+        name = std::string("mariani_silver/brute_force/") + viewCase.name;
+        if (suite.enabled(name)) {
+            std::vector<float> xs(kWidth), ys(kWidth);
+            for (int x = 0; x < kWidth; x++) xs[x] = view.originX + view.stepX * x;
+            BenchResult result = runTimed(name, suite.minTime(), [&]() {
+                for (int y = 0; y < kHeight; y++) {
+                    std::fill(ys.begin(), ys.end(), view.originY + view.stepY * y);
+                    float* out = image.data() + (size_t)y * kWidth;
+                    if (view.fractal == EscapeFractal::Julia) {
+                        computeJuliaRow(xs.data(), ys.data(), out, kWidth, view.juliaX, view.juliaY, view.options);
+                    } else {
+                        computeMandelbrotRow(xs.data(), ys.data(), out, kWidth, view.options);
+                    }
+                }
+            });
+            result.pixels = (double)kWidth * kHeight;
+            suite.add(result);
+        }
+    }
+}
+
+// ============================================================================
+// Deep-zoom perturbation renderer
+// ============================================================================
+
+void benchDeepZoom(BenchSuite& suite) {
+    const int kWidth = 640, kHeight = 360;
+    std::vector<float> image((size_t)kWidth * kHeight);
+    
+    // c = i is a Misiurewicz point: its orbit stays bounded and there is
+    // boundary detail at every scale, so each depth has real work to do
+    const double scales[] = { 1e-6, 1e-15, 1e-30 };
+    const char* depths[] = { "1e-6", "1e-15", "1e-30" };
+    for (int i = 0; i < 3; i++) {
+        std::string name = std::string("deep_zoom/") + depths[i];
+        if (!suite.enabled(name)) continue;
+        
+        DeepZoomView view;
+        view.centerX = DoubleDouble(0.0);
+        view.centerY = DoubleDouble(1.0);
+        view.scale = scales[i] / kWidth;
+        view.maxIterations = 2000;
+        DeepZoomRenderer renderer;
+        BenchResult result = runTimed(name, suite.minTime(), [&]() {
+            renderer.render(kWidth, kHeight, view, image.data(), true);
+        });
+        result.pixels = (double)kWidth * kHeight;
+        suite.add(result);
+    }
+}
+
+// ============================================================================
+// Transcendentals: fast_math.h against libm
+// ============================================================================
+
+void benchMath(BenchSuite& suite) {
+    const int kCount = 4096;
+    std::vector<float> input(kCount), output(kCount);
+    for (int i = 0; i < kCount; i++) input[i] = -100.0f + 200.0f * i / kCount;
+    
+    // The fast cases are written the way hot loops opt in: '#pragma omp simd'
+    // (built with -fopenmp-simd) vectorizes them at -O2
+    using MathFunction = std::function<void(const float*, float*, int)>;
+    struct MathCase { const char* name; MathFunction compute; };
+    const MathCase cases[] = {
+        {"math/fastSin", [](const float* in, float* out, int n) {
+            _Pragma("omp simd") for (int i = 0; i < n; i++) out[i] = fastSin(in[i]); }},
+        {"math/fastCos", [](const float* in, float* out, int n) {
+            _Pragma("omp simd") for (int i = 0; i < n; i++) out[i] = fastCos(in[i]); }},
+        {"math/fastSincos", [](const float* in, float* out, int n) {
+            _Pragma("omp simd") for (int i = 0; i < n; i++) { float s, c; fastSincos(in[i], s, c); out[i] = s + c; } }},
+        {"math/fastExp", [](const float* in, float* out, int n) {
+            _Pragma("omp simd") for (int i = 0; i < n; i++) out[i] = fastExp(in[i] * 0.5f); }},
+        {"math/fastSin/scalar", [](const float* in, float* out, int n) { for (int i = 0; i < n; i++) out[i] = fastSin(in[i]); }},
+        {"math/std::sin(float)", [](const float* in, float* out, int n) { for (int i = 0; i < n; i++) out[i] = std::sin(in[i]); }},
+        {"math/std::exp(float)", [](const float* in, float* out, int n) { for (int i = 0; i < n; i++) out[i] = std::exp(in[i] * 0.5f); }},
+        // What unqualified sin(float) resolves to in the older code: the double overload
+        {"math/sin(double)", [](const float* in, float* out, int n) { for (int i = 0; i < n; i++) out[i] = (float)sin((double)in[i]); }},
+    };
+    
+    for (const MathCase& mathCase : cases) {
+        if (!suite.enabled(mathCase.name)) continue;
+        BenchResult result = runTimed(mathCase.name, suite.minTime(), [&]() {
+            mathCase.compute(input.data(), output.data(), kCount);
+        });
+        result.cells = kCount;
+        suite.add(result);
+    }
+}
+
+// ============================================================================
+// HSV -> ARGB color conversion
+// ============================================================================
+
+void benchColor(BenchSuite& suite) {
+    const int kCount = 1920;
+    std::vector<float> hue(kCount), saturation(kCount), value(kCount);
+    std::vector<uint32_t> output(kCount);
+    Xoshiro256 random(kSeed);
+    random.fillFloats(hue.data(), kCount, -360.0f, 1080.0f);
+    random.fillFloats(saturation.data(), kCount, 0.6f, 1.0f);
+    random.fillFloats(value.data(), kCount, 0.0f, 1.0f);
+    
+    HsvLut lut;
+    HsvLut coarseLut(64, 4, 32);
+    using ColorFunction = std::function<void()>;
+    struct ColorCase { const char* name; ColorFunction convert; };
+    const ColorCase cases[] = {
+        {"color/hsvToRgb", [&]() {
+            for (int i = 0; i < kCount; i++) output[i] = hsvToRgb(hue[i], saturation[i], value[i]); }},
+        {"color/hsvToArgbRow", [&]() {
+            hsvToArgbRow(hue.data(), saturation.data(), value.data(), output.data(), kCount); }},
+        {"color/HsvLut/256x8x64", [&]() {
+            lut.convertRow(hue.data(), saturation.data(), value.data(), output.data(), kCount); }},
+        {"color/HsvLut/64x4x32", [&]() {
+            coarseLut.convertRow(hue.data(), saturation.data(), value.data(), output.data(), kCount); }},
+    };
+    
+    for (const ColorCase& colorCase : cases) {
+        if (!suite.enabled(colorCase.name)) continue;
+        BenchResult result = runTimed(colorCase.name, suite.minTime(), colorCase.convert);
+        result.pixels = kCount;
+        suite.add(result);
+    }
+}
+
+// ============================================================================
+// Game of Life update
+// ============================================================================
+
+void benchGameOfLife(BenchSuite& suite) {
+    struct Resolution { const char* name; int width, height; };
+    const Resolution resolutions[] = {{"720p", 1280, 720}, {"1080p", 1920, 1080}, {"4k", 3840, 2160}};
+    
+    for (const Resolution& res : resolutions) {
+        std::string name = std::string("life/update/") + res.name;
+        if (!suite.enabled(name)) continue;
+        rng.seed(kSeed);
+        FractalGameOfLifeSystem system(res.width, res.height);
+        // Fields computed in the background would make results depend on
+        // worker timing; compute them inline like headless --seed does
+        system.getFractalLayer().setAsync(false);
+        system.update(1.0f / 60.0f); // warm up caches and scratch buffers
+        BenchResult result = runTimed(name, suite.minTime(), [&]() { system.update(1.0f / 60.0f); });
+        result.cells = (double)res.width * res.height;
+        suite.add(result);
+    }
+    
+    // Color pass on its own, straight into a frame
+    for (const Resolution& res : resolutions) {
+        std::string name = std::string("life/render/") + res.name;
+        if (!suite.enabled(name)) continue;
+        rng.seed(kSeed);
+        FractalGameOfLifeSystem system(res.width, res.height);
+        system.getFractalLayer().setAsync(false);
+        PixelBuffer frame(res.width, res.height);
+        system.update(1.0f / 60.0f);
+        system.render(frame.getSpan());
+        BenchResult result = runTimed(name, suite.minTime(), [&]() { system.render(frame.getSpan()); });
+        result.pixels = (double)res.width * res.height;
+        suite.add(result);
+    }
+}
+
+// ============================================================================
+// Entity update
+// ============================================================================
+
+void benchEntityUpdate(BenchSuite& suite) {
+    struct Population { const char* name; int count; };
+    const Population populations[] = {{"25", 25}, {"1k", 1000}, {"10k", 10000}, {"100k", 100000}};
+    
+    for (const Population& population : populations) {
+        std::string name = std::string("entities/update/") + population.name;
+        if (!suite.enabled(name)) continue;
+        rng.seed(kSeed);
+        EntityPool pool;
+        auto refill = [&]() {
+            while (pool.size() < (size_t)population.count) {
+                pool.add(WeirdEntity(Vec3(randomFloat(-3, 3), randomFloat(-2, 2), randomFloat(-6, -2))));
+            }
+        };
+        refill();
+        // Steady state: a 60 Hz step, with the entities that died respawned
+        // so the population stays put
+        BenchResult result = runTimed(name, suite.minTime(), [&]() {
+            pool.update(1.0f / 60.0f);
+            refill();
+        });
+        result.cells = population.count;
+        suite.add(result);
+    }
+}
+
+// ============================================================================
+// Triangle generation
+// ============================================================================
+
+void benchTriangleGeneration(BenchSuite& suite) {
+    // Population scale 1 is the default few dozen entities; x100 reaches
+    // thousands, where the parallel generation pass matters
+    const int scales[] = {1, 100};
+    for (int scale : scales) {
+        std::string name = "entities/getMesh";
+        if (scale != 1) name += "/x" + std::to_string(scale);
+        if (!suite.enabled(name)) continue;
+        
+        rng.seed(kSeed);
+        WeirdVisualManager manager;
+        manager.setPopulationScale(scale);
+        // Simulate a few seconds so the manager is populated with a typical mix
+        for (int i = 0; i < 600; i++) manager.update(1.0f / 60.0f);
+        
+        size_t triangleCount = 0;
+        BenchResult result = runTimed(name, suite.minTime(), [&]() {
+            triangleCount = manager.getMesh().triangleCount;
+        });
+        result.triangles = (double)triangleCount;
+        suite.add(result);
+    }
+}
+
+bool parseOptions(int argc, char** argv, BenchOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) return false;
+        const char* value = argv[++i];
+        if (arg == "--filter") options.filter = value;
+        else if (arg == "--min-time") options.minTime = std::atof(value);
+        else if (arg == "--threads") options.threads = std::atoi(value);
+        else return false;
+    }
+    return options.minTime >= 0 && options.threads >= 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        std::fprintf(stderr, "Usage: %s [--filter SUBSTRING] [--min-time SECONDS] [--threads N]\n", argv[0]);
+        return 1;
+    }
+    if (options.threads > 0) {
+        configureGlobalThreadPool(options.threads);
+    }
+    
+    BenchSuite suite(options);
+    benchRasterizer(suite);
+    benchFractals(suite);
+    benchMarianiSilver(suite);
+    benchDeepZoom(suite);
+    benchMath(suite);
+    benchColor(suite);
+    benchGameOfLife(suite);
+    benchEntityUpdate(suite);
+    benchTriangleGeneration(suite);
+    
+    // Progress goes to stderr, results to stdout
+    suite.writeJson(stdout);
+    return 0;
+}
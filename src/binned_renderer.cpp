@@ -0,0 +1,88 @@
+#include "binned_renderer.h"
+#include "thread_pool.h"
+#include <algorithm>
+
+BinnedRenderer::BinnedRenderer() : screenWidth(0), screenHeight(0), binsX(0), binsY(0) {}
+
+void BinnedRenderer::begin(int width, int height) {
+    screenWidth = width;
+    screenHeight = height;
+    binsX = (screenWidth + kBinSize - 1) / kBinSize;
+    binsY = (screenHeight + kBinSize - 1) / kBinSize;
+    
+    triangles.clear();
+    bins.resize(binsX * binsY);
+    for (auto& bin : bins) {
+        bin.clear();
+    }
+}
+
+void BinnedRenderer::submitMesh(const Vec3* vertices, size_t vertexCount,
+                                const IndexedTriangle* meshTriangles, size_t triangleCount) {
+    // Screen positions by vertex index; triangles read them instead of
+    // projecting their corners again
+    screenVertices.resize(vertexCount);
+    for (size_t i = 0; i < vertexCount; i++) {
+        screenVertices[i] = PixelBuffer::project3DTo2D(vertices[i], screenWidth, screenHeight);
+    }
+    
+    for (size_t i = 0; i < triangleCount; i++) {
+        const IndexedTriangle& triangle = meshTriangles[i];
+        Vec3 normal = faceNormal(vertices[triangle.vertices[0]], vertices[triangle.vertices[1]],
+                                 vertices[triangle.vertices[2]]);
+        if (normal.z <= 0) continue;
+        
+        float intensity = PixelBuffer::lightIntensity(normal);
+        PixelBuffer::ScreenTriangle screen;
+        for (int k = 0; k < 3; k++) {
+            const std::pair<int, int>& p = screenVertices[triangle.vertices[k]];
+            screen.x[k] = p.first;
+            screen.y[k] = p.second;
+            screen.colors[k] = PixelBuffer::applyLighting(triangle.colors[k], intensity);
+        }
+        bin(screen);
+    }
+}
+
+void BinnedRenderer::bin(const PixelBuffer::ScreenTriangle& screen) {
+    // Bin by the screen-clamped bounding box
+    int minX = std::max(0, std::min({screen.x[0], screen.x[1], screen.x[2]}));
+    int maxX = std::min(screenWidth - 1, std::max({screen.x[0], screen.x[1], screen.x[2]}));
+    int minY = std::max(0, std::min({screen.y[0], screen.y[1], screen.y[2]}));
+    int maxY = std::min(screenHeight - 1, std::max({screen.y[0], screen.y[1], screen.y[2]}));
+    if (minX > maxX || minY > maxY) return;
+    
+    uint32_t index = (uint32_t)triangles.size();
+    triangles.push_back(screen);
+    
+    for (int by = minY / kBinSize; by <= maxY / kBinSize; by++) {
+        for (int bx = minX / kBinSize; bx <= maxX / kBinSize; bx++) {
+            bins[by * binsX + bx].push_back(index);
+        }
+    }
+}
+
+void BinnedRenderer::flush(PixelBuffer& target) {
+    activeBins.clear();
+    for (int i = 0; i < (int)bins.size(); i++) {
+        if (!bins[i].empty()) activeBins.push_back(i);
+    }
+    
+    globalThreadPool().parallelFor(activeBins.size(), [&](size_t index, size_t) {
+        int bin = activeBins[index];
+        int bx = bin % binsX;
+        int by = bin / binsX;
+        PixelBuffer::ClipRect clip = {
+            bx * kBinSize, by * kBinSize,
+            std::min(screenWidth, (bx + 1) * kBinSize) - 1,
+            std::min(screenHeight, (by + 1) * kBinSize) - 1
+        };
+        for (uint32_t triangleIndex : bins[bin]) {
+            target.drawScreenTriangle(triangles[triangleIndex], clip);
+        }
+    });
+}
+
+size_t BinnedRenderer::getTriangleCount() const {
+    return triangles.size();
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "pixelbuffer.h"
+#include "utils.h"
+
+// Sort-middle triangle renderer: triangles are projected and lit once, binned
+// into screen tiles, and the tiles are rasterized in parallel. Every tile owns
+// its pixels, so no locking is needed, and each tile draws its triangles in
+// submission order, so overlap resolves exactly as in a serial renderer.
+class BinnedRenderer {
+public:
+    static constexpr int kBinSize = 64; // multiple of the rasterizer tile size
+    
+    BinnedRenderer();
+    
+    // Starts a frame; bin storage is kept between frames
+    void begin(int width, int height);
+    // Queues the triangles of an indexed mesh whose vertices are already
+    // transformed (normalized device coordinates). Each vertex is projected to the screen once however many
+    // triangles share it. Triangles facing away from the camera (normal.z
+    // <= 0) are culled; the rest are lit per face and queued in order.
+    void submitMesh(const Vec3* vertices, size_t vertexCount,
+                    const IndexedTriangle* meshTriangles, size_t triangleCount);
+    // Rasterizes every queued triangle into the target
+    void flush(PixelBuffer& target);
+    
+    size_t getTriangleCount() const;
+    
+private:
+    void bin(const PixelBuffer::ScreenTriangle& screen);
+    
+    int screenWidth, screenHeight;
+    int binsX, binsY;
+    std::vector<PixelBuffer::ScreenTriangle> triangles;
+    std::vector<std::vector<uint32_t>> bins;
+    std::vector<int> activeBins;
+    std::vector<std::pair<int, int>> screenVertices;   // submitMesh's projected vertices
+};
@@ -0,0 +1,80 @@
+#include "deep_zoom.h"
+#include "thread_pool.h"
+#include <atomic>
+
+namespace {
+    constexpr double kBailout = 16.0;  // |z|^2, as computeMandelbrot
+}
+
+void DeepZoomRenderer::computeReference(const DeepZoomView& view) {
+    referenceX.clear();
+    referenceY.clear();
+
+    // Z_0 = 0, Z_n+1 = Z_n^2 + C, kept up to and including the escaping point
+    DoubleDouble zx, zy;
+    for (int i = 0; i <= view.maxIterations; i++) {
+        double x = zx.toDouble(), y = zy.toDouble();
+        referenceX.push_back(x);
+        referenceY.push_back(y);
+        if (x * x + y * y > kBailout) break;
+        DoubleDouble nextX = ddSquare(zx) - ddSquare(zy) + view.centerX;
+        zy = zx * zy * 2.0 + view.centerY;
+        zx = nextX;
+    }
+}
+
+float DeepZoomRenderer::computePixel(double dcx, double dcy, int maxIterations, size_t& rebases) const {
+    const double* refX = referenceX.data();
+    const double* refY = referenceY.data();
+    int last = (int)referenceX.size() - 1;
+    double dzx = 0, dzy = 0;
+    int n = 0;
+
+    for (int i = 0; i < maxIterations; i++) {
+        double zx = refX[n] + dzx;
+        double zy = refY[n] + dzy;
+        double magnitude = zx * zx + zy * zy;
+        if (magnitude > kBailout) {
+            return i / (float)maxIterations;
+        }
+
+        // Rebase: restart the reference with the full orbit as the delta
+        if (magnitude < dzx * dzx + dzy * dzy || n == last) {
+            dzx = zx;
+            dzy = zy;
+            n = 0;
+            rebases++;
+        }
+
+        double Zx = refX[n], Zy = refY[n];
+        double nextX = 2 * (Zx * dzx - Zy * dzy) + (dzx * dzx - dzy * dzy) + dcx;
+        double nextY = 2 * (Zx * dzy + Zy * dzx) + 2 * dzx * dzy + dcy;
+        dzx = nextX;
+        dzy = nextY;
+        n++;
+    }
+    return 1.0f;
+}
+
+void DeepZoomRenderer::render(int width, int height, const DeepZoomView& view, float* output, bool parallel) {
+    computeReference(view);
+
+    std::atomic<size_t> rebases(0);
+    auto renderRow = [&](size_t y, size_t) {
+        size_t rowRebases = 0;
+        float* row = output + y * width;
+        double dcy = ((double)y - height * 0.5) * view.scale;
+        for (int x = 0; x < width; x++) {
+            double dcx = ((double)x - width * 0.5) * view.scale;
+            row[x] = computePixel(dcx, dcy, view.maxIterations, rowRebases);
+        }
+        rebases += rowRebases;
+    };
+
+    if (parallel) {
+        globalThreadPool().parallelFor(height, renderRow);
+    } else {
+        for (int y = 0; y < height; y++) renderRow(y, 0);
+    }
+    rebaseCount = rebases;
+}
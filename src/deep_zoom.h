@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "double_double.h"
+
+// A Mandelbrot view past float precision: pixel (x, y) maps to
+// center + ((x - width / 2) * scale, (y - height / 2) * scale)
+struct DeepZoomView {
+    DoubleDouble centerX, centerY;
+    double scale;            // fractal units per pixel
+    int maxIterations;
+};
+
+// Perturbation renderer for deep Mandelbrot zooms. One reference orbit Z_n
+// is iterated at the view center in double-double; every pixel then only
+// iterates its offset from it,
+//   dz' = 2 Z dz + dz^2 + dc,
+// in plain doubles, whose exponent range covers deltas far below what a float
+// (or double) coordinate can resolve. A pixel whose orbit z = Z + dz comes
+// closer to zero than its delta (the point where perturbation glitches), or
+// that outlives an escaping reference, is rebased onto the start of the
+// reference with dz = z. That keeps a single reference valid for the whole
+// image, so there is no glitch repair pass.
+//
+// Values match computeMandelbrot: i / maxIterations on escape past |z| = 4,
+// 1.0 for points that stay bounded. The center is good to ~106 bits, which
+// puts the limit at a scale of about 1e-30 around centers of order 1.
+// headless --mode deepzoom drives it as a standalone zoom.
+class DeepZoomRenderer {
+public:
+    // Renders width * height floats, row-major, into output. With parallel
+    // set, rows are spread over globalThreadPool().
+    void render(int width, int height, const DeepZoomView& view, float* output, bool parallel);
+
+    int getReferenceLength() const { return (int)referenceX.size(); }
+    size_t getRebaseCount() const { return rebaseCount; }
+
+private:
+    void computeReference(const DeepZoomView& view);
+    float computePixel(double dcx, double dcy, int maxIterations, size_t& rebases) const;
+
+    // Reference orbit rounded to double; deltas carry the fine detail
+    std::vector<double> referenceX, referenceY;
+    size_t rebaseCount = 0;
+};
@@ -0,0 +1,57 @@
+#include "double_double.h"
+
+namespace {
+    DoubleDouble divide(const DoubleDouble& a, const DoubleDouble& b) {
+        double q1 = a.hi / b.hi;
+        DoubleDouble r = a - b * q1;
+        double q2 = r.hi / b.hi;
+        r = r - b * q2;
+        double q3 = r.hi / b.hi;
+        return ddDetail::quickTwoSum(q1, q2) + DoubleDouble(q3);
+    }
+
+    DoubleDouble powerOfTen(int exponent) {
+        DoubleDouble result(1.0);
+        DoubleDouble base(10.0);
+        for (int e = exponent; e > 0; e >>= 1) {
+            if (e & 1) result = result * base;
+            base = ddSquare(base);
+        }
+        return result;
+    }
+}
+
+DoubleDouble parseDoubleDouble(const char* text) {
+    bool negative = false;
+    if (*text == '+' || *text == '-') negative = *text++ == '-';
+
+    // Digits accumulate exactly as long as they fit in ~106 bits; the decimal
+    // point position only moves the final power of ten
+    DoubleDouble value;
+    int exponent = 0;
+    bool fraction = false;
+    for (;; text++) {
+        if (*text >= '0' && *text <= '9') {
+            value = value * 10.0 + DoubleDouble(*text - '0');
+            if (fraction) exponent--;
+        } else if (*text == '.' && !fraction) {
+            fraction = true;
+        } else {
+            break;
+        }
+    }
+    if (*text == 'e' || *text == 'E') {
+        text++;
+        bool negativeExponent = false;
+        if (*text == '+' || *text == '-') negativeExponent = *text++ == '-';
+        int explicitExponent = 0;
+        while (*text >= '0' && *text <= '9' && explicitExponent < 10000) {
+            explicitExponent = explicitExponent * 10 + (*text++ - '0');
+        }
+        exponent += negativeExponent ? -explicitExponent : explicitExponent;
+    }
+
+    if (exponent > 0) value = value * powerOfTen(exponent);
+    if (exponent < 0) value = divide(value, powerOfTen(-exponent));
+    return negative ? -value : value;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cmath>
+
+// Unevaluated sum hi + lo of two doubles with |lo| <= ulp(hi) / 2, giving
+// about 106 bits of mantissa (~32 decimal digits) at double exponent range.
+// Only what the deep-zoom reference orbit needs: add, subtract, multiply and
+// square, using the error-free transformations TwoSum and TwoProd (fma).
+struct DoubleDouble {
+    double hi, lo;
+
+    DoubleDouble() : hi(0), lo(0) {}
+    DoubleDouble(double value) : hi(value), lo(0) {}
+    DoubleDouble(double h, double l) : hi(h), lo(l) {}
+
+    double toDouble() const { return hi + lo; }
+};
+
+namespace ddDetail {
+    // a + b = s + e exactly
+    inline DoubleDouble twoSum(double a, double b) {
+        double s = a + b;
+        double v = s - a;
+        double e = (a - (s - v)) + (b - v);
+        return DoubleDouble(s, e);
+    }
+
+    // Requires |a| >= |b|
+    inline DoubleDouble quickTwoSum(double a, double b) {
+        double s = a + b;
+        return DoubleDouble(s, b - (s - a));
+    }
+
+    // a * b = p + e exactly
+    inline DoubleDouble twoProd(double a, double b) {
+        double p = a * b;
+        return DoubleDouble(p, std::fma(a, b, -p));
+    }
+}
+
+inline DoubleDouble operator+(const DoubleDouble& a, const DoubleDouble& b) {
+    DoubleDouble s = ddDetail::twoSum(a.hi, b.hi);
+    DoubleDouble t = ddDetail::twoSum(a.lo, b.lo);
+    s.lo += t.hi;
+    s = ddDetail::quickTwoSum(s.hi, s.lo);
+    s.lo += t.lo;
+    return ddDetail::quickTwoSum(s.hi, s.lo);
+}
+
+inline DoubleDouble operator-(const DoubleDouble& a) { return DoubleDouble(-a.hi, -a.lo); }
+inline DoubleDouble operator-(const DoubleDouble& a, const DoubleDouble& b) { return a + (-b); }
+
+inline DoubleDouble operator*(const DoubleDouble& a, const DoubleDouble& b) {
+    DoubleDouble p = ddDetail::twoProd(a.hi, b.hi);
+    p.lo += a.hi * b.lo + a.lo * b.hi;
+    return ddDetail::quickTwoSum(p.hi, p.lo);
+}
+
+inline DoubleDouble operator*(const DoubleDouble& a, double b) {
+    DoubleDouble p = ddDetail::twoProd(a.hi, b);
+    p.lo += a.lo * b;
+    return ddDetail::quickTwoSum(p.hi, p.lo);
+}
+
+inline DoubleDouble ddSquare(const DoubleDouble& a) {
+    DoubleDouble p = ddDetail::twoProd(a.hi, a.hi);
+    p.lo += 2.0 * a.hi * a.lo;
+    return ddDetail::quickTwoSum(p.hi, p.lo);
+}
+
+// Parses a decimal number ("-0.7436438870371587522", "1.5e-3") to full
+// double-double precision; stops at the first character it does not know
+DoubleDouble parseDoubleDouble(const char* text);
@@ -0,0 +1,246 @@
+#include "fractal_kernels.h"
+#include <cstdint>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FRACTAL_KERNELS_X86 1
+#endif
+
+namespace {
+
+// The kernels are written once against GCC vector extensions and inlined
+// into per-ISA entry points, so the same source becomes 16-wide AVX-512,
+// 8-wide AVX2 or a 4-wide baseline (SSE2 / NEON). Vectors never
+// cross a non-inlined call, which keeps the ABI independent of the target.
+template <int N> struct Lanes {
+    typedef float Float __attribute__((vector_size(N * sizeof(float))));
+    typedef int32_t Int __attribute__((vector_size(N * sizeof(int32_t))));
+};
+
+// Per-formula constants and step, matching the scalar functions in
+// fractals.cpp (bailout on |z|^2 and the z update)
+struct MandelbrotFormula {
+    static constexpr EscapeFractal kFractal = EscapeFractal::Mandelbrot;
+    static constexpr float kBailout = 16.0f;
+    static constexpr bool kStartAtPoint = false; // z0 = 0, c = point
+    static constexpr bool kAbsolute = false;
+    static constexpr bool kConjugate = false;
+    static constexpr bool kPhoenix = false;
+};
+
+struct JuliaFormula : MandelbrotFormula {
+    static constexpr EscapeFractal kFractal = EscapeFractal::Julia;
+    static constexpr bool kStartAtPoint = true;  // z0 = point, c = parameter
+};
+
+struct BurningShipFormula : MandelbrotFormula {
+    static constexpr EscapeFractal kFractal = EscapeFractal::BurningShip;
+    static constexpr bool kAbsolute = true;
+};
+
+struct TricornFormula : MandelbrotFormula {
+    static constexpr EscapeFractal kFractal = EscapeFractal::Tricorn;
+    static constexpr float kBailout = 4.0f;
+    static constexpr bool kConjugate = true;
+};
+
+struct PhoenixFormula : MandelbrotFormula {
+    static constexpr EscapeFractal kFractal = EscapeFractal::Phoenix;
+    static constexpr float kBailout = 4.0f;
+    static constexpr bool kPhoenix = true;
+};
+
+// Iteration settings as escapeBlock sees them. The defaults of a formula
+// are compile-time constants, so the common case gets a fixed trip count and
+// the unused checks drop out; anything else is read from the options.
+template <typename Formula>
+struct DefaultSettings {
+    static constexpr EscapeTimeOptions kOptions = defaultEscapeTimeOptions(Formula::kFractal);
+    static constexpr int maxIterations() { return kOptions.maxIterations; }
+    static constexpr bool interiorTest() { return kOptions.interiorTest; }
+    static constexpr bool periodicityCheck() { return kOptions.periodicityCheck; }
+};
+
+struct RuntimeSettings {
+    const EscapeTimeOptions& options;
+    int maxIterations() const { return options.maxIterations; }
+    bool interiorTest() const { return options.interiorTest; }
+    bool periodicityCheck() const { return options.periodicityCheck; }
+};
+
+template <typename V>
+inline __attribute__((always_inline)) bool anyLane(const V& mask) {
+    constexpr int n = sizeof(V) / sizeof(mask[0]);
+    int32_t bits = 0;
+    for (int i = 0; i < n; i++) bits |= mask[i];
+    return bits != 0;
+}
+
+template <int N, typename Formula, typename Settings>
+inline __attribute__((always_inline))
+void escapeBlock(const float* xs, const float* ys, float* out, float paramX, float paramY,
+                 const Settings& settings) {
+    typedef typename Lanes<N>::Float VF;
+    typedef typename Lanes<N>::Int VI;
+    
+    VF px, py;
+    std::memcpy(&px, xs, sizeof(VF));
+    std::memcpy(&py, ys, sizeof(VF));
+    
+    const VF zero = {};
+    VF zx, zy, cx, cy;
+    if (Formula::kStartAtPoint) {
+        zx = px; zy = py;
+        cx = zero + paramX; cy = zero + paramY;
+    } else {
+        zx = zero; zy = zero;
+        cx = px; cy = py;
+    }
+    VF prevX = zero, prevY = zero;
+    
+    const VI noLanes = {};
+    const VI absMask = noLanes + 0x7FFFFFFF;  // & clears the sign bit
+    VI active = noLanes == 0;            // all lanes set
+    VI bounded = noLanes;                // lanes resolved as interior by an early exit
+    VI escapeIteration = noLanes;        // valid where active and bounded are clear
+    VI iteration = noLanes;
+    
+    // Main cardioid / period-2 bulb, same arithmetic as inMandelbrotInterior
+    if (settings.interiorTest() && !Formula::kStartAtPoint && !Formula::kAbsolute &&
+        !Formula::kConjugate && !Formula::kPhoenix) {
+        VF xq = cx - 0.25f;
+        VF q = xq * xq + cy * cy;
+        VF xb = cx + 1.0f;
+        bounded = (q * (q + xq) <= 0.25f * cy * cy) | (xb * xb + cy * cy <= 0.0625f);
+        active &= ~bounded;
+    }
+    
+    // Brent-style cycle detection, see OrbitCycleCheck in fractals.cpp. The
+    // checkpoints depend only on the iteration, so all lanes share them.
+    VF savedX = zx, savedY = zy;
+    int checkpoint = 1;
+    
+    const int maxIterations = settings.maxIterations();
+    for (int i = 0; i < maxIterations; i++) {
+        VF zx2 = zx * zx;
+        VF zy2 = zy * zy;
+        VI escaped = active & (zx2 + zy2 > Formula::kBailout);
+        escapeIteration |= escaped & iteration;
+        active &= ~escaped;
+        if (!anyLane(active)) break;
+        
+        VF temp = zx2 - zy2 + cx;
+        VF cross = zx * zy;
+        if (Formula::kPhoenix) {
+            VF tempY = 2 * cross + cy + 0.5f * prevY;
+            temp = temp + 0.5f * prevX;
+            prevX = zx; prevY = zy;
+            zx = temp; zy = tempY;
+        } else if (Formula::kAbsolute) {
+            zy = (VF)((VI)(2 * cross) & absMask) + cy;
+            zx = (VF)((VI)temp & absMask);
+        } else {
+            zy = (Formula::kConjugate ? -2 * cross : 2 * cross) + cy;
+            zx = temp;
+        }
+        
+        if (settings.periodicityCheck()) {
+            VF distance = (VF)((VI)(zx - savedX) & absMask) + (VF)((VI)(zy - savedY) & absMask);
+            VI cycled = active & (distance < kPeriodicityEpsilon);
+            bounded |= cycled;
+            active &= ~cycled;
+            if (i == checkpoint) {
+                savedX = zx;
+                savedY = zy;
+                checkpoint <<= 1;
+            }
+        }
+        iteration += 1;
+    }
+    
+    // Escaped lanes report i / maxIterations, survivors and interiors 1.0
+    VI inside = active | bounded;
+    VF escapedValue = __builtin_convertvector(escapeIteration, VF) / (float)maxIterations;
+    VF result = (VF)((inside & (VI)(zero + 1.0f)) | (~inside & (VI)escapedValue));
+    std::memcpy(out, &result, sizeof(VF));
+}
+
+template <int N, typename Formula, typename Settings>
+inline __attribute__((always_inline))
+void escapeRowWith(const float* xs, const float* ys, float* out, int count, float paramX, float paramY,
+                   const Settings& settings) {
+    int i = 0;
+    for (; i + N <= count; i += N) {
+        escapeBlock<N, Formula>(xs + i, ys + i, out + i, paramX, paramY, settings);
+    }
+    if (i < count) {
+        // Pad the tail by repeating the last point; only count - i lanes are kept
+        float tailX[N], tailY[N], tailOut[N];
+        for (int k = 0; k < N; k++) {
+            int src = i + k < count ? i + k : count - 1;
+            tailX[k] = xs[src];
+            tailY[k] = ys[src];
+        }
+        escapeBlock<N, Formula>(tailX, tailY, tailOut, paramX, paramY, settings);
+        std::memcpy(out + i, tailOut, (count - i) * sizeof(float));
+    }
+}
+
+// Picks the settings once per row, never per point
+template <int N, typename Formula>
+inline __attribute__((always_inline))
+void escapeRow(const float* xs, const float* ys, float* out, int count, float paramX, float paramY,
+               const EscapeTimeOptions& options) {
+    if (options == DefaultSettings<Formula>::kOptions) {
+        escapeRowWith<N, Formula>(xs, ys, out, count, paramX, paramY, DefaultSettings<Formula>());
+    } else {
+        escapeRowWith<N, Formula>(xs, ys, out, count, paramX, paramY, RuntimeSettings{ options });
+    }
+}
+
+// One set of entry points per target; TARGET is empty for the baseline
+#define DEFINE_FRACTAL_KERNELS(SUFFIX, TARGET, N) \
+    TARGET void mandelbrotRow##SUFFIX(const float* xs, const float* ys, float* out, int count, \
+                                      const EscapeTimeOptions& options) { \
+        escapeRow<N, MandelbrotFormula>(xs, ys, out, count, 0, 0, options); } \
+    TARGET void juliaRow##SUFFIX(const float* xs, const float* ys, float* out, int count, float cx, float cy, \
+                                 const EscapeTimeOptions& options) { \
+        escapeRow<N, JuliaFormula>(xs, ys, out, count, cx, cy, options); } \
+    TARGET void burningShipRow##SUFFIX(const float* xs, const float* ys, float* out, int count, \
+                                       const EscapeTimeOptions& options) { \
+        escapeRow<N, BurningShipFormula>(xs, ys, out, count, 0, 0, options); } \
+    TARGET void tricornRow##SUFFIX(const float* xs, const float* ys, float* out, int count, \
+                                   const EscapeTimeOptions& options) { \
+        escapeRow<N, TricornFormula>(xs, ys, out, count, 0, 0, options); } \
+    TARGET void phoenixRow##SUFFIX(const float* xs, const float* ys, float* out, int count, \
+                                   const EscapeTimeOptions& options) { \
+        escapeRow<N, PhoenixFormula>(xs, ys, out, count, 0, 0, options); }
+
+DEFINE_FRACTAL_KERNELS(Generic, , 4)
+
+#ifdef FRACTAL_KERNELS_X86
+DEFINE_FRACTAL_KERNELS(AVX2, __attribute__((target("avx2"))), 8)
+DEFINE_FRACTAL_KERNELS(AVX512, __attribute__((target("avx512f"))), 16)
+#endif
+
+#undef DEFINE_FRACTAL_KERNELS
+
+FractalKernels selectFractalKernels() {
+#ifdef FRACTAL_KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return { "AVX-512", 16, mandelbrotRowAVX512, juliaRowAVX512, burningShipRowAVX512, tricornRowAVX512, phoenixRowAVX512 };
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return { "AVX2", 8, mandelbrotRowAVX2, juliaRowAVX2, burningShipRowAVX2, tricornRowAVX2, phoenixRowAVX2 };
+    }
+#endif
+    return { "Generic", 4, mandelbrotRowGeneric, juliaRowGeneric, burningShipRowGeneric, tricornRowGeneric, phoenixRowGeneric };
+}
+
+} // namespace
+
+const FractalKernels& fractalKernels() {
+    static const FractalKernels kernels = selectFractalKernels();
+    return kernels;
+}
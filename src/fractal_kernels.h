@@ -0,0 +1,48 @@
+#pragma once
+
+#include "fractals.h"
+
+// Row batch versions of the escape-time fractals in fractals.h. Each kernel
+// computes out[i] = compute*(xs[i], ys[i]) for i in [0, count), iterating a
+// whole vector of points at once: lanes that escape are masked off and the
+// loop runs until every lane has escaped or the iteration limit is hit.
+// The scalar functions stay the reference; batch results match them to
+// within float rounding. EscapeTimeOptions apply exactly as in fractals.h.
+using FractalRowKernel = void (*)(const float* xs, const float* ys, float* out, int count,
+                                  const EscapeTimeOptions& options);
+using JuliaRowKernel = void (*)(const float* xs, const float* ys, float* out, int count, float cx, float cy,
+                                const EscapeTimeOptions& options);
+
+// Kernels selected once per process from the host CPU features
+struct FractalKernels {
+    const char* name;
+    int lanes;
+    FractalRowKernel mandelbrot;
+    JuliaRowKernel julia;
+    FractalRowKernel burningShip;
+    FractalRowKernel tricorn;
+    FractalRowKernel phoenix;
+};
+
+const FractalKernels& fractalKernels();
+
+inline void computeMandelbrotRow(const float* xs, const float* ys, float* out, int count,
+                                 const EscapeTimeOptions& options = defaultEscapeTimeOptions(EscapeFractal::Mandelbrot)) {
+    fractalKernels().mandelbrot(xs, ys, out, count, options);
+}
+inline void computeJuliaRow(const float* xs, const float* ys, float* out, int count, float cx, float cy,
+                            const EscapeTimeOptions& options = defaultEscapeTimeOptions(EscapeFractal::Julia)) {
+    fractalKernels().julia(xs, ys, out, count, cx, cy, options);
+}
+inline void computeBurningShipRow(const float* xs, const float* ys, float* out, int count,
+                                  const EscapeTimeOptions& options = defaultEscapeTimeOptions(EscapeFractal::BurningShip)) {
+    fractalKernels().burningShip(xs, ys, out, count, options);
+}
+inline void computeTricornRow(const float* xs, const float* ys, float* out, int count,
+                              const EscapeTimeOptions& options = defaultEscapeTimeOptions(EscapeFractal::Tricorn)) {
+    fractalKernels().tricorn(xs, ys, out, count, options);
+}
+inline void computePhoenixRow(const float* xs, const float* ys, float* out, int count,
+                              const EscapeTimeOptions& options = defaultEscapeTimeOptions(EscapeFractal::Phoenix)) {
+    fractalKernels().phoenix(xs, ys, out, count, options);
+}
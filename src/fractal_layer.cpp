@@ -0,0 +1,250 @@
+#include "fractal_layer.h"
+#include "fractal_kernels.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    constexpr float kPadding = 0.25f;         // extra domain on each side, as a fraction of the extent
+    constexpr float kCoarseTolerance = 1.5f;  // reuse while the field is at most this much coarser
+    constexpr float kJuliaTolerance = 0.01f;  // reuse while the Julia parameter moved less than this
+    constexpr float kMissCoverage = 0.5f;     // below this covered fraction, recompute synchronously
+    constexpr int kMaxFieldSide = 2048;
+    
+    // Row policies for computeFieldRows, one per fractal type, so the type is
+    // resolved once per field instead of once per row
+    struct MandelbrotRows {
+        static void run(const FractalRequest& request, const float* xs, const float* ys, float* out, int count) {
+            computeMandelbrotRow(xs, ys, out, count, request.options);
+        }
+    };
+    struct JuliaRows {
+        static void run(const FractalRequest& request, const float* xs, const float* ys, float* out, int count) {
+            computeJuliaRow(xs, ys, out, count, request.juliaX, request.juliaY, request.options);
+        }
+    };
+    struct BurningShipRows {
+        static void run(const FractalRequest& request, const float* xs, const float* ys, float* out, int count) {
+            computeBurningShipRow(xs, ys, out, count, request.options);
+        }
+    };
+    struct TricornRows {
+        static void run(const FractalRequest& request, const float* xs, const float* ys, float* out, int count) {
+            computeTricornRow(xs, ys, out, count, request.options);
+        }
+    };
+    struct PhoenixRows {
+        static void run(const FractalRequest& request, const float* xs, const float* ys, float* out, int count) {
+            computePhoenixRow(xs, ys, out, count, request.options);
+        }
+    };
+    
+    // The non-escape-time fractals have no batch kernels; the function is a
+    // template argument so each gets its own direct-call loop
+    template <float (*Function)(float, float)>
+    struct PointRows {
+        static void run(const FractalRequest&, const float* xs, const float* ys, float* out, int count) {
+            for (int i = 0; i < count; i++) out[i] = Function(xs[i], ys[i]);
+        }
+    };
+    
+    float overlap(float minA, float maxA, float minB, float maxB) {
+        return std::max(0.0f, std::min(maxA, maxB) - std::max(minA, minB));
+    }
+    
+    // Cell spacing for a padded extent: the target, unless the side cap forces coarser
+    float fieldStep(float paddedExtent, float targetStep) {
+        return std::max(targetStep, paddedExtent / (kMaxFieldSide - 1));
+    }
+}
+
+FractalLayer::FractalLayer() : resolutionScale(0.5f), async(true), recomputeCount(0),
+    stopping(false), requestPending(false), pendingRequest(), pendingScale(resolutionScale) {
+    worker = std::thread(&FractalLayer::workerLoop, this);
+}
+
+FractalLayer::~FractalLayer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    worker.join();
+}
+
+void FractalLayer::setResolutionScale(float scale) {
+    resolutionScale = std::max(0.01f, std::min(1.0f, scale));
+}
+
+FractalLayer::Coverage FractalLayer::classify(const Field* field, const FractalRequest& request) const {
+    if (!field) return Coverage::Miss;
+    const FractalRequest& key = field->key;
+    if (key.type != request.type) return Coverage::Miss;
+    if (request.type <= 4 && !(key.options == request.options)) return Coverage::Miss;
+    
+    float fieldMaxX = field->originX + field->stepX * (field->width - 1);
+    float fieldMaxY = field->originY + field->stepY * (field->height - 1);
+    float requestArea = (request.maxX - request.minX) * (request.maxY - request.minY);
+    float coveredArea = overlap(field->originX, fieldMaxX, request.minX, request.maxX) *
+                        overlap(field->originY, fieldMaxY, request.minY, request.maxY);
+    if (coveredArea < requestArea * kMissCoverage) return Coverage::Miss;
+    
+    if (request.minX < field->originX || request.maxX > fieldMaxX ||
+        request.minY < field->originY || request.maxY > fieldMaxY) {
+        return Coverage::Stale;
+    }
+    float targetStep = request.spacing / resolutionScale;
+    float paddedScale = 1.0f + 2.0f * kPadding;
+    if (field->stepX > fieldStep((request.maxX - request.minX) * paddedScale, targetStep) * kCoarseTolerance ||
+        field->stepY > fieldStep((request.maxY - request.minY) * paddedScale, targetStep) * kCoarseTolerance) {
+        return Coverage::Stale;
+    }
+    if (request.type == 1 && (std::fabs(key.juliaX - request.juliaX) > kJuliaTolerance ||
+                              std::fabs(key.juliaY - request.juliaY) > kJuliaTolerance)) {
+        return Coverage::Stale;
+    }
+    return Coverage::Valid;
+}
+
+void FractalLayer::prepare(const FractalRequest& request) {
+    // Install a field the worker finished since the last frame, unless the
+    // fractal changed underneath it
+    std::shared_ptr<Field> ready;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ready.swap(finished);
+    }
+    if (ready && classify(ready.get(), request) != Coverage::Miss) {
+        current = std::move(ready);
+        recomputeCount++;
+    }
+    
+    Coverage coverage = classify(current.get(), request);
+    if (coverage == Coverage::Valid) return;
+    
+    if (coverage == Coverage::Miss || !async) {
+        current = computeField(request, resolutionScale, true);
+        recomputeCount++;
+        return;
+    }
+    
+    // Stale: keep sampling the current field, the newest request wins
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pendingRequest = request;
+        pendingScale = resolutionScale;
+        requestPending = true;
+    }
+    wake.notify_one();
+}
+
+std::shared_ptr<FractalLayer::Field> FractalLayer::computeField(const FractalRequest& request, float scale, bool parallel) {
+    auto field = std::make_shared<Field>();
+    field->key = request;
+    
+    // Pad the requested domain so small drift stays inside the field
+    float extentX = std::max(request.maxX - request.minX, 1e-12f);
+    float extentY = std::max(request.maxY - request.minY, 1e-12f);
+    float minX = request.minX - extentX * kPadding, maxX = request.maxX + extentX * kPadding;
+    float minY = request.minY - extentY * kPadding, maxY = request.maxY + extentY * kPadding;
+    
+    float targetStep = std::max(request.spacing / scale, 1e-12f);
+    field->width = std::max(2, (int)std::ceil((maxX - minX) / fieldStep(maxX - minX, targetStep)) + 1);
+    field->height = std::max(2, (int)std::ceil((maxY - minY) / fieldStep(maxY - minY, targetStep)) + 1);
+    field->originX = minX;
+    field->originY = minY;
+    field->stepX = (maxX - minX) / (field->width - 1);
+    field->stepY = (maxY - minY) / (field->height - 1);
+    field->values.resize((size_t)field->width * field->height);
+    
+    switch (request.type) {
+        case 0: computeFieldRows<MandelbrotRows>(*field, parallel); break;
+        case 1: computeFieldRows<JuliaRows>(*field, parallel); break;
+        case 2: computeFieldRows<BurningShipRows>(*field, parallel); break;
+        case 3: computeFieldRows<TricornRows>(*field, parallel); break;
+        case 4: computeFieldRows<PhoenixRows>(*field, parallel); break;
+        case 5: computeFieldRows<PointRows<computeNova>>(*field, parallel); break;
+        case 6: computeFieldRows<PointRows<computePsychedelicWaves>>(*field, parallel); break;
+        case 7: computeFieldRows<PointRows<computeStrangeAttractor>>(*field, parallel); break;
+        case 8: computeFieldRows<PointRows<computeChaosFractal>>(*field, parallel); break;
+    }
+    return field;
+}
+
+template <typename Rows>
+void FractalLayer::computeFieldRows(Field& field, bool parallel) {
+    auto computeRow = [&field](int y, std::vector<float>& xs, std::vector<float>& ys) {
+        int count = field.width;
+        xs.resize(count);
+        ys.resize(count);
+        float rowY = field.originY + field.stepY * y;
+        for (int x = 0; x < count; x++) {
+            xs[x] = field.originX + field.stepX * x;
+            ys[x] = rowY;
+        }
+        float* out = field.values.data() + (size_t)y * count;
+        Rows::run(field.key, xs.data(), ys.data(), out, count);
+        
+        // Diverging fractals (the Henon attractor) can return NaN or inf;
+        // bilinear sampling would spread it into every neighboring cell
+        for (int x = 0; x < count; x++) {
+            if (!std::isfinite(out[x])) out[x] = 0.0f;
+        }
+    };
+    
+    if (parallel) {
+        ThreadPool& pool = globalThreadPool();
+        std::vector<std::vector<float>> xs(pool.getWorkerCount()), ys(pool.getWorkerCount());
+        pool.parallelFor(field.height, [&](size_t y, size_t worker) {
+            computeRow((int)y, xs[worker], ys[worker]);
+        });
+    } else {
+        std::vector<float> xs, ys;
+        for (int y = 0; y < field.height; y++) {
+            computeRow(y, xs, ys);
+        }
+    }
+}
+
+void FractalLayer::sampleRow(const float* xs, const float* ys, float* out, int count) const {
+    const Field& field = *current;
+    float invStepX = 1.0f / field.stepX;
+    float invStepY = 1.0f / field.stepY;
+    float maxU = (float)(field.width - 1);
+    float maxV = (float)(field.height - 1);
+    const float* values = field.values.data();
+    
+    for (int i = 0; i < count; i++) {
+        float u = std::max(0.0f, std::min(maxU, (xs[i] - field.originX) * invStepX));
+        float v = std::max(0.0f, std::min(maxV, (ys[i] - field.originY) * invStepY));
+        int ix = std::min((int)u, field.width - 2);
+        int iy = std::min((int)v, field.height - 2);
+        float tx = u - ix, ty = v - iy;
+        
+        const float* top = values + (size_t)iy * field.width + ix;
+        const float* bottom = top + field.width;
+        float upper = top[0] + (top[1] - top[0]) * tx;
+        float lower = bottom[0] + (bottom[1] - bottom[0]) * tx;
+        out[i] = upper + (lower - upper) * ty;
+    }
+}
+
+void FractalLayer::workerLoop() {
+    while (true) {
+        FractalRequest request;
+        float scale;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return stopping || requestPending; });
+            if (stopping) return;
+            request = pendingRequest;
+            scale = pendingScale;
+            requestPending = false;
+        }
+        
+        std::shared_ptr<Field> field = computeField(request, scale, false);
+        
+        std::lock_guard<std::mutex> lock(mutex);
+        finished = std::move(field);
+    }
+}
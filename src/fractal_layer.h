@@ -0,0 +1,83 @@
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "fractals.h"
+
+// What the Game of Life needs from the fractal for one frame: the fractal,
+// the rectangle of (warped) fractal coordinates it will sample and the
+// spacing of its cells in fractal units.
+struct FractalRequest {
+    int type;                    // 0..8, as fractalType % 9
+    float minX, maxX, minY, maxY;
+    float spacing;
+    float juliaX, juliaY;        // Julia parameter (type 1 only)
+    EscapeTimeOptions options;   // escape-time types (0..4) only
+};
+
+// Cached fractal field, decoupled from the CA grid. The field is evaluated
+// over a padded domain at a configurable fraction of the CA resolution and
+// sampled bilinearly, so it is reused while the view drifts inside the
+// padding. When the request leaves the cached field it is recomputed on a
+// dedicated worker thread while the stale field keeps being sampled; only a
+// change of fractal or a jump to a mostly uncovered domain recomputes
+// synchronously. Sampling is safe from any number of threads between
+// prepare() calls.
+class FractalLayer {
+public:
+    FractalLayer();
+    ~FractalLayer();
+    
+    FractalLayer(const FractalLayer&) = delete;
+    FractalLayer& operator=(const FractalLayer&) = delete;
+    
+    // Field cells per CA cell along each axis, in (0, 1]
+    void setResolutionScale(float scale);
+    float getResolutionScale() const { return resolutionScale; }
+    
+    // With async off every miss recomputes synchronously, which keeps the
+    // output independent of worker timing (reproducible runs)
+    void setAsync(bool enabled) { async = enabled; }
+    bool isAsync() const { return async; }
+    
+    // Makes a field covering request current; call once per frame before sampling
+    void prepare(const FractalRequest& request);
+    
+    // Bilinear samples at fractal coordinates, clamped to the cached domain
+    void sampleRow(const float* xs, const float* ys, float* out, int count) const;
+    
+    size_t getRecomputeCount() const { return recomputeCount; }
+    
+private:
+    struct Field {
+        FractalRequest key;
+        float originX, originY;
+        float stepX, stepY;
+        int width, height;
+        std::vector<float> values;
+    };
+    
+    enum class Coverage { Valid, Stale, Miss };
+    Coverage classify(const Field* field, const FractalRequest& request) const;
+    static std::shared_ptr<Field> computeField(const FractalRequest& request, float scale, bool parallel);
+    template <typename Rows> static void computeFieldRows(Field& field, bool parallel);
+    void workerLoop();
+    
+    float resolutionScale;
+    bool async;
+    size_t recomputeCount;
+    std::shared_ptr<const Field> current;
+    
+    // Worker state, guarded by mutex
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping;
+    bool requestPending;
+    FractalRequest pendingRequest;
+    float pendingScale;
+    std::shared_ptr<Field> finished;
+    std::thread worker;
+};
@@ -1,6 +1,8 @@
 #include "fractal_system.h"
+#include "fast_math.h"
 #include "fractals.h"
 #include "pixelbuffer.h"
+#include "thread_pool.h"
 #include <cmath>
 #include <algorithm>
 
@@ -9,30 +11,46 @@ FractalGameOfLifeSystem* g_fractalSystem = nullptr;
 
 FractalGameOfLifeSystem::FractalGameOfLifeSystem(int w, int h) : width(w), height(h), time(0), fractalType(0), 
     zoomLevel(1.0f), center(0, 0, 0), warpIntensity(1.0f), colorShift(0), 
-    pulseSpeed(1.0f), chaosLevel(0.5f), isTripping(false) {
-    
-    grid.resize(height, std::vector<float>(width, 0.0f));
-    nextGrid.resize(height, std::vector<float>(width, 0.0f));
-    energyGrid.resize(height, std::vector<float>(width, 0.0f));
-    velocityX.resize(height, std::vector<float>(width, 0.0f));
-    velocityY.resize(height, std::vector<float>(width, 0.0f));
-    colorGrid.resize(height, std::vector<uint32_t>(width, 0xFF000000));
-    trailGrid.resize(height, std::vector<float>(width, 0.0f));
+    pulseSpeed(1.0f), chaosLevel(0.5f), isTripping(false), randomSeed(0), frameCounter(0) {
     
+    for (int i = 0; i < kEscapeFractalCount; i++) {
+        escapeOptions[i] = defaultEscapeTimeOptions((EscapeFractal)i);
+    }
+    allocateGrids();
     initialize();
+    colorState = { time, colorShift, zoomLevel, center.x, center.y, isTripping };
+}
+
+void FractalGameOfLifeSystem::allocateGrids() {
+    grid.resize(width, height, 0.0f);
+    nextGrid.resize(width, height, 0.0f);
+    energyGrid.resize(width, height, 0.0f);
+    velocityX.resize(width, height, 0.0f);
+    velocityY.resize(width, height, 0.0f);
+    trailGrid.resize(width, height, 0.0f);
+    energyScatter.resize(width, height, 0.0f);
 }
 
 void FractalGameOfLifeSystem::initialize() {
-    // Seed with psychedelic patterns
+    // Seed with psychedelic patterns; random values are drawn a row at a time
+    std::vector<float> jitter(width), level(width);
     for (int y = 0; y < height; y++) {
+        float* gridRow = grid.row(y);
+        float* energyRow = energyGrid.row(y);
+        rng.fillFloats(jitter.data(), width, -0.5f, 0.5f);
+        rng.fillFloats(level.data(), width, 0.3f, 1.0f);
+        rng.fillFloats(energyRow, width, 0, 0.5f);
         for (int x = 0; x < width; x++) {
             float noise1 = sin(x * 0.1f) * cos(y * 0.08f);
             float noise2 = sin(x * 0.03f + y * 0.05f) * 0.5f;
-            grid[y][x] = (noise1 + noise2 + randomFloat(-0.5f, 0.5f)) > 0 ? randomFloat(0.3f, 1.0f) : 0.0f;
-            energyGrid[y][x] = randomFloat(0, 0.5f);
-            trailGrid[y][x] = 0.0f;
+            gridRow[x] = (noise1 + noise2 + jitter[x]) > 0 ? level[x] : 0.0f;
         }
     }
+    trailGrid.fill(0.0f);
+    
+    // Seed for the per-band random streams of update()
+    randomSeed = rng.next();
+    frameCounter = 0;
     
     fractalType = randomInt(0, 8);
     zoomLevel = randomFloat(0.05f, 5.0f);
@@ -83,45 +101,159 @@ void FractalGameOfLifeSystem::update(float deltaTime) {
         attractor.z += sin(time * randomFloat(0.5f, 2.0f)) * chaosLevel * 0.05f;
     }
     
-    // Extreme game of life with multiple rule sets
-    for (int y = 1; y < height - 1; y++) {
-        for (int x = 1; x < width - 1; x++) {
-            float current = grid[y][x];
-            
-            // Multiple overlapping neighborhood calculations for chaos
-            float neighbors1 = 0, neighbors2 = 0, neighbors3 = 0;
-            
-            // Standard neighbors
-            for (int dy = -1; dy <= 1; dy++) {
-                for (int dx = -1; dx <= 1; dx++) {
-                    if (dx == 0 && dy == 0) continue;
-                    neighbors1 += grid[y + dy][x + dx];
+    // Extreme game of life with multiple rule sets, run as fixed-height row
+    // bands on the thread pool. Each band draws from its own counter-based
+    // stream keyed by (seed, frame, band), so the result does not depend on
+    // the number of threads. Energy waves are staged in energyScatter: a band
+    // only scatters into its neighbors' rows, so even and odd bands run as
+    // two passes and never write the same cell concurrently.
+    frameCounter++;
+    colorState = { time, colorShift, zoomLevel, center.x, center.y, isTripping };
+    fractalLayer.prepare(makeFractalRequest());
+    ThreadPool& pool = globalThreadPool();
+    bandScratch.resize(pool.getWorkerCount());
+    int bandCount = (height - 2 + kBandRows - 1) / kBandRows;
+    int pairCount = (bandCount + 1) / 2;
+    
+    for (int parity = 0; parity < 2; parity++) {
+        pool.parallelFor(pairCount, [&](size_t pair, size_t worker) {
+            int band = (int)pair * 2 + parity;
+            if (band >= bandCount) return;
+            int yBegin = 1 + band * kBandRows;
+            int yEnd = std::min(height - 1, yBegin + kBandRows);
+            CounterRng random(randomSeed, frameCounter, band);
+            updateRows(yBegin, yEnd, bandScratch[worker], random);
+        });
+    }
+    
+    // Fold the staged energy waves in, clearing the stage (halo included)
+    pool.parallelFor(bandCount, [&](size_t band, size_t) {
+        int yBegin = band == 0 ? -Grid2D<float>::kHalo : 1 + (int)band * kBandRows;
+        int yEnd = (int)band == bandCount - 1 ? height + Grid2D<float>::kHalo : 1 + ((int)band + 1) * kBandRows;
+        for (int y = yBegin; y < yEnd; y++) {
+            float* scatterRow = energyScatter.row(y);
+            if (y >= 0 && y < height) {
+                float* energyRow = energyGrid.row(y);
+                for (int x = 0; x < width; x++) {
+                    energyRow[x] += scatterRow[x];
                 }
             }
-            
-            // Extended neighbors (2-cell radius) for more complex patterns
-            for (int dy = -2; dy <= 2; dy++) {
-                for (int dx = -2; dx <= 2; dx++) {
-                    if (dx == 0 && dy == 0) continue;
-                    if (y + dy >= 0 && y + dy < height && x + dx >= 0 && x + dx < width) {
-                        neighbors2 += grid[y + dy][x + dx] * 0.3f;
-                    }
-                }
+            energyScatter.clearRow(y);
+        }
+    });
+    
+    // Swap grids
+    grid.swap(nextGrid);
+    
+    // Randomly inject chaos patterns
+    if (randomFloat(0, 1) < 0.1f * chaosLevel) {
+        int cx = randomInt(10, width - 10);
+        int cy = randomInt(10, height - 10);
+        int patternType = randomInt(0, 5);
+        
+        switch (patternType) {
+            case 0: injectSpinner(cx, cy); break;
+            case 1: injectGlider(cx, cy); break;
+            case 2: injectExploder(cx, cy); break;
+            case 3: injectChaosBlob(cx, cy); break;
+            case 4: injectEnergyVortex(cx, cy); break;
+        }
+    }
+    
+    // Occasionally completely randomize fractal parameters
+    if (randomFloat(0, 1) < 0.03f) {
+        fractalType = randomInt(0, 12);
+        zoomLevel = randomFloat(0.01f, 10.0f);
+        center = Vec3(randomFloat(-5, 5), randomFloat(-5, 5), randomFloat(-2, 2));
+        warpIntensity = randomFloat(0.5f, 20.0f);
+        
+        // Add new attractors randomly
+        if (randomFloat(0, 1) < 0.5f) {
+            attractors.push_back(Vec3(randomFloat(-3, 3), randomFloat(-3, 3), randomFloat(-1, 1)));
+            if (attractors.size() > 8) {
+                attractors.erase(attractors.begin());
             }
+        }
+    }
+}
+
+// The rectangle of warped fractal coordinates the interior cells will
+// sample this frame, for the fractal layer
+FractalRequest FractalGameOfLifeSystem::makeFractalRequest() const {
+    FractalRequest request;
+    request.type = fractalType % 9;
+    
+    float x0 = (1 - width * 0.5f) / (width * 0.5f) * zoomLevel + center.x;
+    float x1 = (width - 2 - width * 0.5f) / (width * 0.5f) * zoomLevel + center.x;
+    float y0 = (1 - height * 0.5f) / (height * 0.5f) * zoomLevel + center.y;
+    float y1 = (height - 2 - height * 0.5f) / (height * 0.5f) * zoomLevel + center.y;
+    float warpMargin = std::fabs(warpIntensity) * 0.5f;
+    request.minX = std::min(x0, x1) - warpMargin;
+    request.maxX = std::max(x0, x1) + warpMargin;
+    request.minY = std::min(y0, y1) - warpMargin;
+    request.maxY = std::max(y0, y1) + warpMargin;
+    request.spacing = std::fabs(zoomLevel) / (std::max(width, height) * 0.5f);
+    
+    request.juliaX = sin(time * 0.5f);
+    request.juliaY = cos(time * 0.7f);
+    request.options = request.type <= 4 ? escapeOptions[request.type] : escapeOptions[0];
+    return request;
+}
+
+// Fills scratch.fractalRow with the fractal value of every interior cell of
+// row y, sampled from the fractal layer at the warped coordinates
+void FractalGameOfLifeSystem::computeFractalRow(int y, BandScratch& scratch) const {
+    scratch.warpX.resize(width);
+    scratch.warpY.resize(width);
+    scratch.fractalRow.resize(width);
+    float* warpX = scratch.warpX.data();
+    float* warpY = scratch.warpY.data();
+    
+    // Apply extreme warp distortion
+    float fy = (y - height * 0.5f) / (height * 0.5f) * zoomLevel + center.y;
+    float rowWarpX = fastSin(time * 2.0f + fy * 3.0f) * warpIntensity * 0.5f;
+    #pragma omp simd
+    for (int x = 1; x < width - 1; x++) {
+        float fx = (x - width * 0.5f) / (width * 0.5f) * zoomLevel + center.x;
+        warpX[x] = fx + rowWarpX;
+        warpY[x] = fy + fastCos(time * 1.5f + fx * 2.0f) * warpIntensity * 0.5f;
+    }
+    
+    if (width > 2) {
+        fractalLayer.sampleRow(warpX + 1, warpY + 1, scratch.fractalRow.data() + 1, width - 2);
+    }
+}
+
+void FractalGameOfLifeSystem::updateRows(int yBegin, int yEnd, BandScratch& scratch, CounterRng& random) {
+    NeighborhoodSums& neighborhood = scratch.neighborhood;
+    neighborhood.begin(grid, yBegin);
+    for (int y = yBegin; y < yEnd; y++) {
+        neighborhood.computeRow(y);
+        computeFractalRow(y, scratch);
+        const float* fractalRow = scratch.fractalRow.data();
+        const float* ring3 = neighborhood.ring3();
+        const float* ring5 = neighborhood.ring5();
+        const float* diagonals = neighborhood.diagonals();
+        
+        const float* gridRow = grid.row(y);
+        float* nextRow = nextGrid.row(y);
+        float* energyRow = energyGrid.row(y);
+        float* velXRow = velocityX.row(y);
+        float* velYRow = velocityY.row(y);
+        float* trailRow = trailGrid.row(y);
+        
+        for (int x = 1; x < width - 1; x++) {
+            float current = gridRow[x];
             
-            // Diagonal-only neighbors for extra patterns
-            for (int i = -2; i <= 2; i++) {
-                for (int j = -2; j <= 2; j++) {
-                    if (abs(i) == abs(j) && i != 0) {
-                        if (y + i >= 0 && y + i < height && x + j >= 0 && x + j < width) {
-                            neighbors3 += grid[y + i][x + j] * 0.5f;
-                        }
-                    }
-                }
-            }
+            // Multiple overlapping neighborhood calculations for chaos:
+            // standard 3x3 neighbors, extended 2-cell radius neighbors and
+            // diagonal-only neighbors, all precomputed for the row
+            float neighbors1 = ring3[x];
+            float neighbors2 = ring5[x] * 0.3f;
+            float neighbors3 = diagonals[x] * 0.5f;
             
             // Combine all neighbor calculations with chaos
-            float totalNeighbors = neighbors1 + neighbors2 * chaosLevel + neighbors3 * sin(time + x * 0.1f);
+            float totalNeighbors = neighbors1 + neighbors2 * chaosLevel + neighbors3 * fastSin(time + x * 0.1f);
             
             // Multiple rule sets that change dynamically
             float newValue = current;
@@ -132,7 +264,7 @@ void FractalGameOfLifeSystem::update(float deltaTime) {
                     if (current > 0.1f) {
                         newValue = (totalNeighbors >= 2.0f && totalNeighbors <= 3.5f) ? current * 1.1f : current * 0.8f;
                     } else {
-                        newValue = (totalNeighbors >= 2.8f && totalNeighbors <= 3.2f) ? randomFloat(0.5f, 1.0f) : 0;
+                        newValue = (totalNeighbors >= 2.8f && totalNeighbors <= 3.2f) ? random.nextFloat(0.5f, 1.0f) : 0;
                     }
                     break;
                     
@@ -140,30 +272,30 @@ void FractalGameOfLifeSystem::update(float deltaTime) {
                     if (current > 0.1f) {
                         newValue = (totalNeighbors >= 2.0f && totalNeighbors <= 3.0f) ? current * 1.05f : current * 0.9f;
                     } else {
-                        newValue = (totalNeighbors >= 3.5f && totalNeighbors <= 4.0f) ? randomFloat(0.3f, 0.8f) : 0;
+                        newValue = (totalNeighbors >= 3.5f && totalNeighbors <= 4.0f) ? random.nextFloat(0.3f, 0.8f) : 0;
                     }
                     break;
                     
                 case 2: // Seeds - explosive growth
-                    newValue = (totalNeighbors >= 2.0f) ? randomFloat(0.4f, 1.2f) : current * 0.95f;
+                    newValue = (totalNeighbors >= 2.0f) ? random.nextFloat(0.4f, 1.2f) : current * 0.95f;
                     break;
                     
                 case 3: // Day & Night - inverted
                     if (current > 0.1f) {
                         newValue = (totalNeighbors >= 3.0f && totalNeighbors <= 4.0f) ? current * 1.2f : current * 0.7f;
                     } else {
-                        newValue = (totalNeighbors >= 3.0f && totalNeighbors <= 4.0f) ? randomFloat(0.6f, 1.0f) : 0;
+                        newValue = (totalNeighbors >= 3.0f && totalNeighbors <= 4.0f) ? random.nextFloat(0.6f, 1.0f) : 0;
                     }
                     break;
                     
                 case 4: { // Continuous life - smooth transitions
-                    float smoothFactor = sin(totalNeighbors * 0.5f + time) * 0.5f + 0.5f;
+                    float smoothFactor = fastSin(totalNeighbors * 0.5f + time) * 0.5f + 0.5f;
                     newValue = current * 0.9f + smoothFactor * chaosLevel * 0.3f;
                     break;
                 }
                     
                 case 5: { // Chaos mode - pure randomness influenced by neighbors
-                    newValue = current * 0.8f + randomFloat(0, totalNeighbors * 0.2f * chaosLevel);
+                    newValue = current * 0.8f + random.nextFloat(0, totalNeighbors * 0.2f * chaosLevel);
                     break;
                 }
             }
@@ -172,148 +304,143 @@ void FractalGameOfLifeSystem::update(float deltaTime) {
             float fx = (x - width * 0.5f) / (width * 0.5f) * zoomLevel + center.x;
             float fy = (y - height * 0.5f) / (height * 0.5f) * zoomLevel + center.y;
             
-            // Apply extreme warp distortion
-            float warpX = fx + sin(time * 2.0f + fy * 3.0f) * warpIntensity * 0.5f;
-            float warpY = fy + cos(time * 1.5f + fx * 2.0f) * warpIntensity * 0.5f;
-            
-            float fractalValue = 0;
-            switch (fractalType % 9) {
-                case 0: fractalValue = computeMandelbrot(warpX, warpY); break;
-                case 1: fractalValue = computeJulia(warpX, warpY, sin(time * 0.5f), cos(time * 0.7f)); break;
-                case 2: fractalValue = computeBurningShip(warpX, warpY); break;
-                case 3: fractalValue = computeTricorn(warpX, warpY); break;
-                case 4: fractalValue = computePhoenix(warpX, warpY); break;
-                case 5: fractalValue = computeNova(warpX, warpY); break;
-                case 6: fractalValue = computePsychedelicWaves(warpX, warpY); break;
-                case 7: fractalValue = computeStrangeAttractor(warpX, warpY); break;
-                case 8: fractalValue = computeChaosFractal(warpX, warpY); break;
-            }
-            
             // Blend cellular automaton with fractal
-            newValue = newValue * 0.6f + fractalValue * 0.4f * chaosLevel;
+            newValue = newValue * 0.6f + fractalRow[x] * 0.4f * chaosLevel;
             
             // Add attractor influences
             for (const auto& attractor : attractors) {
                 float dx = fx - attractor.x;
                 float dy = fy - attractor.y;
-                float distance = sqrt(dx * dx + dy * dy) + 0.001f;
+                float distance = std::sqrt(dx * dx + dy * dy) + 0.001f;
                 float influence = (1.0f / distance) * 0.1f * chaosLevel;
-                newValue += influence * sin(time * 3.0f + distance * 10.0f);
+                newValue += influence * fastSin(time * 3.0f + distance * 10.0f);
             }
             
             // Velocity field for fluid-like motion
-            float velInfluence = sin(time * 2.0f + fx * 5.0f) * cos(time * 1.7f + fy * 4.0f);
-            velocityX[y][x] = velocityX[y][x] * 0.95f + velInfluence * chaosLevel * 0.1f;
-            velocityY[y][x] = velocityY[y][x] * 0.95f + cos(time * 1.3f + fx * 3.0f) * chaosLevel * 0.1f;
+            float velInfluence = fastSin(time * 2.0f + fx * 5.0f) * fastCos(time * 1.7f + fy * 4.0f);
+            velXRow[x] = velXRow[x] * 0.95f + velInfluence * chaosLevel * 0.1f;
+            velYRow[x] = velYRow[x] * 0.95f + fastCos(time * 1.3f + fx * 3.0f) * chaosLevel * 0.1f;
             
             // Apply velocity to position for fluid motion
-            newValue += (velocityX[y][x] + velocityY[y][x]) * 0.2f;
+            newValue += (velXRow[x] + velYRow[x]) * 0.2f;
             
             // Energy accumulation for explosive effects
-            energyGrid[y][x] += abs(newValue - current) * 0.5f;
-            if (energyGrid[y][x] > randomFloat(0.8f, 1.5f)) {
-                newValue += randomFloat(0.5f, 1.0f); // Energy explosion
-                energyGrid[y][x] = 0;
+            energyRow[x] += std::fabs(newValue - current) * 0.5f;
+            if (energyRow[x] > random.nextFloat(0.8f, 1.5f)) {
+                newValue += random.nextFloat(0.5f, 1.0f); // Energy explosion
+                energyRow[x] = 0;
                 
-                // Create energy wave around explosion
+                // Create energy wave around explosion, staged for after the
+                // sweep. The 3-cell halo absorbs the part outside the grid.
                 for (int dy = -3; dy <= 3; dy++) {
+                    float* r = energyScatter.row(y + dy);
                     for (int dx = -3; dx <= 3; dx++) {
-                        if (y + dy >= 0 && y + dy < height && x + dx >= 0 && x + dx < width) {
-                            float dist = sqrt(dx * dx + dy * dy);
-                            if (dist > 0.1f) {
-                                energyGrid[y + dy][x + dx] += 0.3f / dist;
-                            }
+                        float dist = sqrt(dx * dx + dy * dy);
+                        if (dist > 0.1f) {
+                            r[x + dx] += 0.3f / dist;
                         }
                     }
                 }
             }
             
             // Trail effects for motion blur
-            trailGrid[y][x] = std::max(trailGrid[y][x] * 0.92f, newValue * 0.3f);
+            trailRow[x] = std::max(trailRow[x] * 0.92f, newValue * 0.3f);
             
             // Clamp and add noise
             newValue = std::max(0.0f, std::min(2.0f, newValue));
-            if (randomFloat(0, 1) < 0.02f * chaosLevel) {
-                newValue += randomFloat(-0.5f, 0.5f);
+            if (random.nextFloat(0, 1) < 0.02f * chaosLevel) {
+                newValue += random.nextFloat(-0.5f, 0.5f);
             }
             
-            nextGrid[y][x] = newValue;
-            
-            // Generate psychedelic colors
-            float intensity = newValue + trailGrid[y][x];
-            float hue = fmod(intensity * 180.0f + colorShift + fx * 50.0f + fy * 30.0f + time * 100.0f, 360.0f);
-            float saturation = 0.8f + sin(time * 3.0f + intensity * 5.0f) * 0.2f;
-            float brightness = std::min(1.f, float(intensity * (0.5f + sin(time * 4.0f) * 0.3f)));
-            
-            // Add rainbow cycling and strobe effects
-            if (isTripping) {
-                hue += sin(time * 10.0f + x * 0.2f) * 60.0f;
-                saturation = 1.0f;
-                brightness *= (0.7f + sin(time * 15.0f + y * 0.3f) * 0.3f);
-            }
-            
-            colorGrid[y][x] = hsvToRgb(hue, saturation, brightness);
+            nextRow[x] = newValue;
         }
     }
+}
+
+// Psychedelic colors of row y from the cell values and trails, converted
+// to ARGB straight into out. Interior cells only; the caller does the border.
+void FractalGameOfLifeSystem::colorRow(int y, uint32_t* out, BandScratch& scratch) const {
+    scratch.hue.resize(width);
+    scratch.saturation.resize(width);
+    scratch.brightness.resize(width);
+    float* hueRow = scratch.hue.data();
+    float* saturationRow = scratch.saturation.data();
+    float* brightnessRow = scratch.brightness.data();
     
-    // Swap grids
-    grid.swap(nextGrid);
+    const ColorState state = colorState;   // a local copy, so the loops need not reload it
+    int columns = width;
+    float halfWidth = width * 0.5f;
+    const float* gridRow = grid.row(y);
+    const float* trailRow = trailGrid.row(y);
+    float fy = (y - height * 0.5f) / (height * 0.5f) * state.zoomLevel + state.centerY;
+    float rowHue = state.colorShift + fy * 30.0f + state.time * 100.0f;
+    float brightnessPulse = 0.5f + fastSin(state.time * 4.0f) * 0.3f;
     
-    // Randomly inject chaos patterns
-    if (randomFloat(0, 1) < 0.1f * chaosLevel) {
-        int cx = randomInt(10, width - 10);
-        int cy = randomInt(10, height - 10);
-        int patternType = randomInt(0, 5);
-        
-        switch (patternType) {
-            case 0: injectSpinner(cx, cy); break;
-            case 1: injectGlider(cx, cy); break;
-            case 2: injectExploder(cx, cy); break;
-            case 3: injectChaosBlob(cx, cy); break;
-            case 4: injectEnergyVortex(cx, cy); break;
-        }
+    #pragma omp simd
+    for (int x = 1; x < columns - 1; x++) {
+        float fx = (x - halfWidth) / halfWidth * state.zoomLevel + state.centerX;
+        float intensity = gridRow[x] + trailRow[x];
+        hueRow[x] = intensity * 180.0f + fx * 50.0f + rowHue;
+        saturationRow[x] = 0.8f + fastSin(state.time * 3.0f + intensity * 5.0f) * 0.2f;
+        brightnessRow[x] = intensity * brightnessPulse;   // the converter clamps to 1
     }
     
-    // Occasionally completely randomize fractal parameters
-    if (randomFloat(0, 1) < 0.03f) {
-        fractalType = randomInt(0, 12);
-        zoomLevel = randomFloat(0.01f, 10.0f);
-        center = Vec3(randomFloat(-5, 5), randomFloat(-5, 5), randomFloat(-2, 2));
-        warpIntensity = randomFloat(0.5f, 20.0f);
-        
-        // Add new attractors randomly
-        if (randomFloat(0, 1) < 0.5f) {
-            attractors.push_back(Vec3(randomFloat(-3, 3), randomFloat(-3, 3), randomFloat(-1, 1)));
-            if (attractors.size() > 8) {
-                attractors.erase(attractors.begin());
-            }
+    // Add rainbow cycling and strobe effects
+    if (state.tripping) {
+        float strobe = 0.7f + fastSin(state.time * 15.0f + y * 0.3f) * 0.3f;
+        #pragma omp simd
+        for (int x = 1; x < columns - 1; x++) {
+            hueRow[x] += fastSin(state.time * 10.0f + x * 0.2f) * 60.0f;
+            saturationRow[x] = 1.0f;
+            brightnessRow[x] = std::min(brightnessRow[x] * strobe, strobe);
         }
     }
+    
+    if (colorLut) {
+        colorLut->convertRow(hueRow + 1, saturationRow + 1, brightnessRow + 1, out + 1, columns - 2);
+    } else {
+        hsvToArgbRow(hueRow + 1, saturationRow + 1, brightnessRow + 1, out + 1, columns - 2);
+    }
 }
 
-void FractalGameOfLifeSystem::render(PixelBuffer& pixelBuffer) {
-    int bufferWidth = pixelBuffer.getWidth();
-    int bufferHeight = pixelBuffer.getHeight();
+void FractalGameOfLifeSystem::render(const PixelSpan& target) {
+    int rows = std::min(target.height, height);
+    int columns = std::min(target.width, width);
+    if (rows <= 0 || columns <= 0) return;
     
-    for (int y = 0; y < bufferHeight && y < colorGrid.size(); y++) {
-        for (int x = 0; x < bufferWidth && x < colorGrid[y].size(); x++) {
-            pixelBuffer.setPixel(x, y, colorGrid[y][x]);
+    // Rows that fit whole are converted in place; a target narrower than the
+    // grid gets its rows through a scratch row
+    ThreadPool& pool = globalThreadPool();
+    bandScratch.resize(pool.getWorkerCount());
+    int bandCount = (rows + kBandRows - 1) / kBandRows;
+    pool.parallelFor(bandCount, [&](size_t band, size_t worker) {
+        BandScratch& scratch = bandScratch[worker];
+        int yBegin = (int)band * kBandRows;
+        int yEnd = std::min(rows, yBegin + kBandRows);
+        for (int y = yBegin; y < yEnd; y++) {
+            uint32_t* out = target.row(y);
+            if (y == 0 || y == height - 1 || width < 3) {
+                std::fill(out, out + columns, 0xFF000000u);
+                continue;
+            }
+            if (columns == width) {
+                colorRow(y, out, scratch);
+            } else {
+                scratch.colors.resize(width);
+                colorRow(y, scratch.colors.data(), scratch);
+                std::copy(scratch.colors.begin(), scratch.colors.begin() + columns, out);
+            }
+            out[0] = 0xFF000000u;
+            if (columns == width) out[width - 1] = 0xFF000000u;
         }
-    }
+    });
 }
 
 void FractalGameOfLifeSystem::resize(int newWidth, int newHeight) {
     width = newWidth;
     height = newHeight;
     
-    grid.resize(height, std::vector<float>(width, 0.0f));
-    nextGrid.resize(height, std::vector<float>(width, 0.0f));
-    energyGrid.resize(height, std::vector<float>(width, 0.0f));
-    velocityX.resize(height, std::vector<float>(width, 0.0f));
-    velocityY.resize(height, std::vector<float>(width, 0.0f));
-    colorGrid.resize(height, std::vector<uint32_t>(width, 0xFF000000));
-    trailGrid.resize(height, std::vector<float>(width, 0.0f));
-    
+    allocateGrids();
     initialize();
 }
 
@@ -332,6 +459,26 @@ std::string FractalGameOfLifeSystem::getCurrentModeName() const {
     }
 }
 
+const EscapeTimeOptions& FractalGameOfLifeSystem::getEscapeTimeOptions(EscapeFractal fractal) const {
+    return escapeOptions[(int)fractal];
+}
+
+void FractalGameOfLifeSystem::setEscapeTimeOptions(EscapeFractal fractal, const EscapeTimeOptions& options) {
+    escapeOptions[(int)fractal] = options;
+}
+
+FractalLayer& FractalGameOfLifeSystem::getFractalLayer() {
+    return fractalLayer;
+}
+
+void FractalGameOfLifeSystem::setColorLut(int hueSteps, int saturationSteps, int valueSteps) {
+    if (hueSteps <= 0 || saturationSteps <= 0 || valueSteps <= 0) {
+        colorLut.reset();
+    } else {
+        colorLut = std::make_unique<HsvLut>(hueSteps, saturationSteps, valueSteps);
+    }
+}
+
 void FractalGameOfLifeSystem::injectSpinner(int cx, int cy) {
     if (cx >= 1 && cx < width-1 && cy >= 1 && cy < height-1) {
         setCell(cx, cy, 1.0f);
@@ -396,7 +543,7 @@ void FractalGameOfLifeSystem::injectEnergyVortex(int cx, int cy) {
 
 void FractalGameOfLifeSystem::setCell(int x, int y, float value) {
     if (x >= 0 && x < width && y >= 0 && y < height) {
-        grid[y][x] = value;
+        grid(x, y) = value;
     }
 }
 
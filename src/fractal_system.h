@@ -1,22 +1,29 @@
 #pragma once
 
+#include <memory>
 #include <vector>
 #include <string>
 #include "utils.h"
-
-// Forward declaration
-class PixelBuffer;
+#include "grid2d.h"
+#include "neighborhood_sums.h"
+#include "rng.h"
+#include "fractals.h"
+#include "fractal_layer.h"
+#include "hsv_color.h"
+#include "pixelbuffer.h"
 
 // EXTREME HALLUCINOGENIC FRACTAL/GAME OF LIFE SYSTEM
 class FractalGameOfLifeSystem {
 private:
     int width, height;
-    std::vector<std::vector<float>> grid;
-    std::vector<std::vector<float>> nextGrid;
-    std::vector<std::vector<float>> energyGrid;
-    std::vector<std::vector<float>> velocityX, velocityY;
-    std::vector<std::vector<uint32_t>> colorGrid;
-    std::vector<std::vector<float>> trailGrid;
+    // One contiguous aligned allocation per field (see Grid2D); the zeroed
+    // halo stands in for the out-of-range neighbors of the stencils
+    Grid2D<float> grid;
+    Grid2D<float> nextGrid;
+    Grid2D<float> energyGrid;
+    Grid2D<float> velocityX, velocityY;
+    Grid2D<float> trailGrid;
+    Grid2D<float> energyScatter;   // energy waves staged during update()
     float time;
     int fractalType;
     float zoomLevel;
@@ -27,17 +34,57 @@ private:
     float chaosLevel;
     bool isTripping;
     std::vector<Vec3> attractors;
+    EscapeTimeOptions escapeOptions[kEscapeFractalCount];
+    FractalLayer fractalLayer;   // cached fractal field sampled by the CA
+    std::unique_ptr<HsvLut> colorLut;  // null: exact hsvToArgbRow
+    
+    // Parameters of the last update's sweep, so render() colors the cells
+    // with the view they were computed in even if update() moved on after
+    struct ColorState {
+        float time, colorShift, zoomLevel;
+        float centerX, centerY;
+        bool tripping;
+    };
+    ColorState colorState;
+    
+    // Parallel update state
+    static constexpr int kBandRows = 16; // >= 7 so same-parity bands never share scatter rows
+    uint64_t randomSeed;
+    uint64_t frameCounter;
+    
+    // Per-worker scratch for updateRows
+    struct BandScratch {
+        NeighborhoodSums neighborhood;
+        std::vector<float> warpX, warpY;  // warped fractal coordinates of a row
+        std::vector<float> fractalRow;    // fractal layer sampled at each cell of the row
+        std::vector<float> hue, saturation, brightness;  // HSV of a row, converted in one pass
+        std::vector<uint32_t> colors;     // a row for targets narrower than the grid
+    };
+    std::vector<BandScratch> bandScratch; // one per pool worker
     
 public:
     FractalGameOfLifeSystem(int w, int h);
     
     void initialize();
     void update(float deltaTime);
-    void render(PixelBuffer& pixelBuffer);
+    // Colors the cells straight into target, border black. Only the overlap
+    // with the grid is written; the rest of target is left alone.
+    void render(const PixelSpan& target);
     void resize(int newWidth, int newHeight);
     
     std::string getCurrentModeName() const;
     
+    // Iteration limit and early-exit checks used for each escape-time fractal
+    const EscapeTimeOptions& getEscapeTimeOptions(EscapeFractal fractal) const;
+    void setEscapeTimeOptions(EscapeFractal fractal, const EscapeTimeOptions& options);
+    
+    // Resolution and async recompute of the cached fractal field
+    FractalLayer& getFractalLayer();
+    
+    // Quantized HSV table for the cell colors (see HsvLut); 0 steps = exact
+    void setColorLut(int hueSteps, int saturationSteps, int valueSteps);
+    const HsvLut* getColorLut() const { return colorLut.get(); }
+    
     // Pattern injection methods
     void injectSpinner(int cx, int cy);
     void injectGlider(int cx, int cy);
@@ -47,6 +94,12 @@ public:
     void setCell(int x, int y, float value);
     
 private:
+    void allocateGrids();
+    void updateRows(int yBegin, int yEnd, BandScratch& scratch, CounterRng& random);
+    void colorRow(int y, uint32_t* out, BandScratch& scratch) const;
+    void computeFractalRow(int y, BandScratch& scratch) const;
+    FractalRequest makeFractalRequest() const;
+
     void generateFractalLevel(std::vector<Triangle3D>& triangles, Vec3 center, float scale, int level, int maxLevel) const;
 };
 
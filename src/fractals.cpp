@@ -1,10 +1,40 @@
 #include "fractals.h"
+#include "fast_math.h"
 #include <cmath>
 
+namespace {
+    // Brent-style cycle detection: the orbit is compared with a saved point
+    // that is replaced at iterations 1, 2, 4, 8, ..., so a cycle of any
+    // period is caught once the window grows past it
+    struct OrbitCycleCheck {
+        float savedX, savedY;
+        int checkpoint;
+        
+        OrbitCycleCheck(float zx, float zy) : savedX(zx), savedY(zy), checkpoint(1) {}
+        
+        bool closed(int i, float zx, float zy) {
+            if (std::fabs(zx - savedX) + std::fabs(zy - savedY) < kPeriodicityEpsilon) return true;
+            if (i == checkpoint) {
+                savedX = zx;
+                savedY = zy;
+                checkpoint <<= 1;
+            }
+            return false;
+        }
+    };
+}
+
 float computeMandelbrot(float x, float y) {
+    static constexpr EscapeTimeOptions options = defaultEscapeTimeOptions(EscapeFractal::Mandelbrot);
+    return computeMandelbrot(x, y, options);
+}
+
+float computeMandelbrot(float x, float y, const EscapeTimeOptions& options) {
     float cx = x, cy = y;
     float zx = 0, zy = 0;
-    int maxIterations = 25; // Reduced from 50 for better performance
+    int maxIterations = options.maxIterations;
+    if (options.interiorTest && inMandelbrotInterior(cx, cy)) return 1.0f;
+    OrbitCycleCheck cycle(zx, zy);
     
     for (int i = 0; i < maxIterations; i++) {
         float zx2 = zx * zx;
@@ -15,13 +45,20 @@ float computeMandelbrot(float x, float y) {
         float temp = zx2 - zy2 + cx;
         zy = 2 * zx * zy + cy;
         zx = temp;
+        if (options.periodicityCheck && cycle.closed(i, zx, zy)) return 1.0f;
     }
     return 1.0f;
 }
 
 float computeJulia(float x, float y, float cx, float cy) {
+    static constexpr EscapeTimeOptions options = defaultEscapeTimeOptions(EscapeFractal::Julia);
+    return computeJulia(x, y, cx, cy, options);
+}
+
+float computeJulia(float x, float y, float cx, float cy, const EscapeTimeOptions& options) {
     float zx = x, zy = y;
-    int maxIterations = 25; // Reduced from 50
+    int maxIterations = options.maxIterations;
+    OrbitCycleCheck cycle(zx, zy);
     
     for (int i = 0; i < maxIterations; i++) {
         float zx2 = zx * zx;
@@ -32,14 +69,21 @@ float computeJulia(float x, float y, float cx, float cy) {
         float temp = zx2 - zy2 + cx;
         zy = 2 * zx * zy + cy;
         zx = temp;
+        if (options.periodicityCheck && cycle.closed(i, zx, zy)) return 1.0f;
     }
     return 1.0f;
 }
 
 float computeBurningShip(float x, float y) {
+    static constexpr EscapeTimeOptions options = defaultEscapeTimeOptions(EscapeFractal::BurningShip);
+    return computeBurningShip(x, y, options);
+}
+
+float computeBurningShip(float x, float y, const EscapeTimeOptions& options) {
     float cx = x, cy = y;
     float zx = 0, zy = 0;
-    int maxIterations = 20; // Further reduced for this complex fractal
+    int maxIterations = options.maxIterations;
+    OrbitCycleCheck cycle(zx, zy);
     
     for (int i = 0; i < maxIterations; i++) {
         float zx2 = zx * zx;
@@ -48,16 +92,23 @@ float computeBurningShip(float x, float y) {
             return i / (float)maxIterations;
         }
         float temp = zx2 - zy2 + cx;
-        zy = abs(2 * zx * zy) + cy;
-        zx = abs(temp);
+        zy = std::fabs(2 * zx * zy) + cy;
+        zx = std::fabs(temp);
+        if (options.periodicityCheck && cycle.closed(i, zx, zy)) return 1.0f;
     }
     return 1.0f;
 }
 
 float computeTricorn(float x, float y) {
+    static constexpr EscapeTimeOptions options = defaultEscapeTimeOptions(EscapeFractal::Tricorn);
+    return computeTricorn(x, y, options);
+}
+
+float computeTricorn(float x, float y, const EscapeTimeOptions& options) {
     float cx = x, cy = y;
     float zx = 0, zy = 0;
-    int maxIterations = 50;
+    int maxIterations = options.maxIterations;
+    OrbitCycleCheck cycle(zx, zy);
     
     for (int i = 0; i < maxIterations; i++) {
         float zx2 = zx * zx;
@@ -68,15 +119,22 @@ float computeTricorn(float x, float y) {
         float temp = zx2 - zy2 + cx;
         zy = -2 * zx * zy + cy;
         zx = temp;
+        if (options.periodicityCheck && cycle.closed(i, zx, zy)) return 1.0f;
     }
     return 1.0f;
 }
 
 float computePhoenix(float x, float y) {
+    static constexpr EscapeTimeOptions options = defaultEscapeTimeOptions(EscapeFractal::Phoenix);
+    return computePhoenix(x, y, options);
+}
+
+float computePhoenix(float x, float y, const EscapeTimeOptions& options) {
     float cx = x, cy = y;
     float zx = 0, zy = 0;
     float px = 0, py = 0;
-    int maxIterations = 50;
+    int maxIterations = options.maxIterations;
+    OrbitCycleCheck cycle(zx, zy);
     
     for (int i = 0; i < maxIterations; i++) {
         float zx2 = zx * zx;
@@ -88,6 +146,7 @@ float computePhoenix(float x, float y) {
         float temp_y = 2 * zx * zy + cy + 0.5f * py;
         px = zx; py = zy;
         zx = temp; zy = temp_y;
+        if (options.periodicityCheck && cycle.closed(i, zx, zy)) return 1.0f;
     }
     return 1.0f;
 }
@@ -116,7 +175,7 @@ float computeNova(float x, float y) {
 }
 
 float computePsychedelicWaves(float x, float y) {
-    return (sin(x * 5.0f) * cos(y * 3.0f) + sin(x * y * 2.0f) + cos(x + y)) * 0.5f + 0.5f;
+    return (fastSin(x * 5.0f) * fastCos(y * 3.0f) + fastSin(x * y * 2.0f) + fastCos(x + y)) * 0.5f + 0.5f;
 }
 
 float computeStrangeAttractor(float x, float y) {
@@ -132,7 +191,7 @@ float computeStrangeAttractor(float x, float y) {
 float computeChaosFractal(float x, float y) {
     float result = 0;
     for (int i = 0; i < 5; i++) {
-        result += sin(x * (i + 1) * 2.0f) * cos(y * (i + 1) * 1.5f) / (i + 1);
+        result += fastSin(x * (i + 1) * 2.0f) * fastCos(y * (i + 1) * 1.5f) / (i + 1);
     }
     return fmod(abs(result), 1.0f);
 }
\ No newline at end of file
@@ -1,11 +1,63 @@
 #pragma once
 
+// Escape-time fractals of the Mandelbrot family
+enum class EscapeFractal { Mandelbrot, Julia, BurningShip, Tricorn, Phoenix };
+constexpr int kEscapeFractalCount = 5;
+
+// Iteration settings for an escape-time fractal. Points caught by either
+// early exit are reported as bounded (1.0), like points that survive all
+// iterations, so the checks only change how quickly interiors are resolved.
+struct EscapeTimeOptions {
+    int maxIterations;
+    bool interiorTest;      // analytic main cardioid / period-2 bulb test (Mandelbrot only)
+    bool periodicityCheck;  // Brent-style detection of orbits that settled into a cycle
+};
+
+// Per-fractal defaults: the iteration limits the renderer has always used,
+// interior test for Mandelbrot, periodicity for Mandelbrot and Julia. Burning
+// Ship, Tricorn and Phoenix run without either by default. constexpr so the
+// batch kernels can specialize on them.
+constexpr EscapeTimeOptions defaultEscapeTimeOptions(EscapeFractal fractal) {
+    switch (fractal) {
+        case EscapeFractal::Mandelbrot: return { 25, true, true };   // Reduced from 50 for better performance
+        case EscapeFractal::Julia: return { 25, false, true };       // Reduced from 50
+        case EscapeFractal::BurningShip: return { 20, false, false }; // Further reduced for this complex fractal
+        case EscapeFractal::Tricorn: return { 50, false, false };
+        case EscapeFractal::Phoenix: return { 50, false, false };
+    }
+    return { 25, false, false };
+}
+
+constexpr bool operator==(const EscapeTimeOptions& a, const EscapeTimeOptions& b) {
+    return a.maxIterations == b.maxIterations && a.interiorTest == b.interiorTest &&
+           a.periodicityCheck == b.periodicityCheck;
+}
+
+// Orbits within this distance (|dx| + |dy|) of the saved point count as cycled
+constexpr float kPeriodicityEpsilon = 1e-6f;
+
+// True for points in the main cardioid or the period-2 bulb of the Mandelbrot set
+inline bool inMandelbrotInterior(float x, float y) {
+    float xq = x - 0.25f;
+    float q = xq * xq + y * y;
+    if (q * (q + xq) <= 0.25f * y * y) return true;
+    float xb = x + 1.0f;
+    return xb * xb + y * y <= 0.0625f;
+}
+
 // Fractal computation functions - optimized for performance
 float computeMandelbrot(float x, float y);
 float computeJulia(float x, float y, float cx, float cy);
 float computeBurningShip(float x, float y);
 float computeTricorn(float x, float y);
 float computePhoenix(float x, float y);
+
+// Same kernels with explicit iteration settings
+float computeMandelbrot(float x, float y, const EscapeTimeOptions& options);
+float computeJulia(float x, float y, float cx, float cy, const EscapeTimeOptions& options);
+float computeBurningShip(float x, float y, const EscapeTimeOptions& options);
+float computeTricorn(float x, float y, const EscapeTimeOptions& options);
+float computePhoenix(float x, float y, const EscapeTimeOptions& options);
 float computeNova(float x, float y);
 float computePsychedelicWaves(float x, float y);
 float computeStrangeAttractor(float x, float y);
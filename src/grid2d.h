@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <algorithm>
+#include <utility>
+
+// Contiguous, cache-line aligned 2D field with a zeroed halo border.
+// Rows are padded to a whole number of cache lines and column 0 starts on a
+// cache line, so row(y) can be streamed linearly. Cells up to kHalo outside
+// the grid in either direction are valid to read (and write): they hold T()
+// after resize(), which lets stencils run without per-neighbor bounds checks.
+template <typename T>
+class Grid2D {
+public:
+    static constexpr int kHalo = 3;
+    static constexpr size_t kAlignment = 64;
+    static constexpr int kLineElems = (int)(kAlignment / sizeof(T));
+    static constexpr int kLeftPad = ((kHalo + kLineElems - 1) / kLineElems) * kLineElems;
+
+    Grid2D() : width(0), height(0), stride(0), origin(nullptr) {}
+    Grid2D(int w, int h, T value = T()) : Grid2D() { resize(w, h, value); }
+
+    Grid2D(Grid2D&& other) noexcept : Grid2D() { swap(other); }
+    Grid2D& operator=(Grid2D&& other) noexcept { swap(other); return *this; }
+    Grid2D(const Grid2D&) = delete;
+    Grid2D& operator=(const Grid2D&) = delete;
+
+    // Reallocates for the new size; interior cells get value, halo cells T()
+    void resize(int w, int h, T value = T()) {
+        width = w;
+        height = h;
+        stride = ((kLeftPad + w + kHalo + kLineElems - 1) / kLineElems) * kLineElems;
+
+        size_t rows = (size_t)h + 2 * kHalo;
+        size_t count = rows * stride;
+        storage.reset(static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(kAlignment))));
+        std::fill(storage.get(), storage.get() + count, T());
+        origin = storage.get() + (size_t)kHalo * stride + kLeftPad;
+        fill(value);
+    }
+
+    // Sets every interior cell; the halo is left untouched
+    void fill(T value) {
+        for (int y = 0; y < height; y++) {
+            std::fill(row(y), row(y) + width, value);
+        }
+    }
+
+    // Resets one row (y in [-kHalo, height + kHalo)) including its halo columns
+    void clearRow(int y) {
+        std::fill(row(y) - kLeftPad, row(y) - kLeftPad + stride, T());
+    }
+
+    T* row(int y) { return origin + (ptrdiff_t)y * stride; }
+    const T* row(int y) const { return origin + (ptrdiff_t)y * stride; }
+
+    T& operator()(int x, int y) { return row(y)[x]; }
+    const T& operator()(int x, int y) const { return row(y)[x]; }
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    int getStride() const { return stride; }
+
+    void swap(Grid2D& other) noexcept {
+        std::swap(storage, other.storage);
+        std::swap(width, other.width);
+        std::swap(height, other.height);
+        std::swap(stride, other.stride);
+        std::swap(origin, other.origin);
+    }
+
+private:
+    struct AlignedDelete {
+        void operator()(T* p) const { ::operator delete(p, std::align_val_t(kAlignment)); }
+    };
+
+    std::unique_ptr<T, AlignedDelete> storage;
+    int width, height, stride;
+    T* origin;
+};
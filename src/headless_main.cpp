@@ -0,0 +1,317 @@
+// Headless front end: drives the same Scene as the SDL build with a fixed
+// timestep, without a window or any SDL dependency. Frames can be discarded
+// (for benchmarking) or streamed as raw ARGB8888 to a file or stdout. Two
+// standalone Mandelbrot modes sit next to the Scene ones: a progressive
+// Mariani-Silver render that outputs every refinement pass, and a deep zoom
+// on the perturbation renderer.
+#include <chrono>
+#include <cstdio>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "utils.h"
+#include "pixelbuffer.h"
+#include "scene.h"
+#include "raster_kernels.h"
+#include "fractal_kernels.h"
+#include "thread_pool.h"
+#include "hsv_color.h"
+#include "mariani_silver.h"
+#include "deep_zoom.h"
+
+namespace {
+
+enum class HeadlessMode { Chaos, Fractal, Progressive, DeepZoom };
+
+const char* modeName(HeadlessMode mode) {
+    switch (mode) {
+        case HeadlessMode::Chaos: return "chaos";
+        case HeadlessMode::Fractal: return "fractal";
+        case HeadlessMode::Progressive: return "progressive";
+        case HeadlessMode::DeepZoom: return "deepzoom";
+    }
+    return "?";
+}
+
+struct HeadlessOptions {
+    int width = 1280;
+    int height = 720;
+    int frames = 300;
+    float deltaTime = 1.0f / 60.0f;
+    HeadlessMode mode = HeadlessMode::Chaos;
+    bool seeded = false;
+    uint64_t seed = 0;
+    int threads = 0;          // 0 = one per hardware thread
+    int colorLut[3] = {};     // hue, saturation, value steps; 0 = exact colors
+    int population = 1;       // weird entity population scale
+    std::string output;       // empty = discard, "-" = stdout
+    
+    // Standalone Mandelbrot modes. The center is kept as text so deepzoom
+    // can parse it to full double-double precision.
+    std::string centerX = "-0.743643887037158704752191506114774";
+    std::string centerY = "0.131825904205311970493132056385139";
+    double extent = 3.2;      // fractal units across the width
+    double zoom = 0.9;        // extent factor per frame (deepzoom) or finished image (progressive)
+    int iterations = 1000;
+};
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --width N        Frame width (default 1280)\n"
+              << "  --height N       Frame height (default 720)\n"
+              << "  --frames N       Number of frames to render (default 300)\n"
+              << "  --dt SECONDS     Fixed timestep (default 1/60)\n"
+              << "  --mode MODE      chaos, fractal, progressive or deepzoom (default chaos)\n"
+              << "  --seed N         Seed the random generator for reproducible runs\n"
+              << "  --threads N      Render threads (default: all hardware threads)\n"
+              << "  --color-lut H,S,V  Fractal mode colors from an HSV table with these steps\n"
+              << "  --population N   Chaos mode entity cap and spawn batch times N (default 1)\n"
+              << "  --output PATH    Write raw ARGB8888 frames to PATH, '-' for stdout\n"
+              << "Progressive and deepzoom modes (standalone Mandelbrot views):\n"
+              << "  --center X,Y     View center (default: a point in the seahorse valley)\n"
+              << "  --extent W       Width of the first view in fractal units (default 3.2)\n"
+              << "  --zoom F         Extent factor per frame, or per finished image in\n"
+              << "                   progressive mode (default 0.9)\n"
+              << "  --iterations N   Iteration limit (default 1000)\n"
+              << "Progressive mode outputs every Mariani-Silver refinement pass as a frame,\n"
+              << "then zooms and starts over. Deepzoom renders a full frame per step and\n"
+              << "holds up to an extent of about 1e-30; raise --iterations as it goes deeper.\n";
+}
+
+bool parseOptions(int argc, char** argv, HeadlessOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            return false;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << "\n";
+            return false;
+        }
+        const char* value = argv[++i];
+        if (arg == "--width") options.width = std::atoi(value);
+        else if (arg == "--height") options.height = std::atoi(value);
+        else if (arg == "--frames") options.frames = std::atoi(value);
+        else if (arg == "--dt") options.deltaTime = (float)std::atof(value);
+        else if (arg == "--threads") options.threads = std::atoi(value);
+        else if (arg == "--population") options.population = std::atoi(value);
+        else if (arg == "--extent") options.extent = std::atof(value);
+        else if (arg == "--zoom") options.zoom = std::atof(value);
+        else if (arg == "--iterations") options.iterations = std::atoi(value);
+        else if (arg == "--output") options.output = value;
+        else if (arg == "--seed") {
+            options.seed = std::strtoull(value, nullptr, 10);
+            options.seeded = true;
+        } else if (arg == "--color-lut") {
+            int* steps = options.colorLut;
+            if (std::sscanf(value, "%d,%d,%d", &steps[0], &steps[1], &steps[2]) != 3 ||
+                steps[0] <= 0 || steps[1] <= 0 || steps[2] <= 0) {
+                std::cerr << "Expected --color-lut H,S,V with positive steps\n";
+                return false;
+            }
+        } else if (arg == "--center") {
+            const char* comma = std::strchr(value, ',');
+            if (!comma || comma == value || comma[1] == '\0') {
+                std::cerr << "Expected --center X,Y\n";
+                return false;
+            }
+            options.centerX.assign(value, comma);
+            options.centerY = comma + 1;
+        } else if (arg == "--mode") {
+            std::string mode = value;
+            if (mode == "chaos") options.mode = HeadlessMode::Chaos;
+            else if (mode == "fractal") options.mode = HeadlessMode::Fractal;
+            else if (mode == "progressive") options.mode = HeadlessMode::Progressive;
+            else if (mode == "deepzoom") options.mode = HeadlessMode::DeepZoom;
+            else {
+                std::cerr << "Unknown mode: " << mode << "\n";
+                return false;
+            }
+        } else {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return false;
+        }
+    }
+    if (options.width <= 0 || options.height <= 0 || options.frames < 0 || options.threads < 0 || options.population <= 0) {
+        std::cerr << "Width, height, frames, threads and population must be positive\n";
+        return false;
+    }
+    if (options.extent <= 0 || options.zoom <= 0 || options.iterations <= 0) {
+        std::cerr << "Extent, zoom and iterations must be positive\n";
+        return false;
+    }
+    return true;
+}
+
+// Escape values (i / maxIterations, 1.0 for bounded points) to colors:
+// hue cycles with the escape time, the set itself is black
+void colorEscapeValues(const std::vector<float>& values, PixelBuffer& target) {
+    for (int y = 0; y < target.getHeight(); y++) {
+        const float* row = values.data() + (size_t)y * target.getWidth();
+        for (int x = 0; x < target.getWidth(); x++) {
+            float value = row[x];
+            target.setPixel(x, y, value >= 1.0f ? 0xFF000000u
+                                                : hsvToArgb(220.0f + value * 2160.0f, 0.8f, 1.0f));
+        }
+    }
+}
+
+// Mariani-Silver render shown while it refines: every frame is one pass,
+// incomplete rectangles previewed blocky. Once an image is final the view
+// zooms in by options.zoom and the next frame starts a new render.
+class ProgressiveMandelbrot {
+public:
+    explicit ProgressiveMandelbrot(const HeadlessOptions& options)
+        : width(options.width), height(options.height), zoom(options.zoom),
+          centerX(std::atof(options.centerX.c_str())), centerY(std::atof(options.centerY.c_str())),
+          extent(options.extent), values((size_t)options.width * options.height) {
+        view.fractal = EscapeFractal::Mandelbrot;
+        view.options = defaultEscapeTimeOptions(EscapeFractal::Mandelbrot);
+        view.options.maxIterations = options.iterations;
+        view.juliaX = view.juliaY = 0;
+    }
+    
+    void renderFrame(PixelBuffer& target) {
+        if (!refining) {
+            view.stepX = view.stepY = (float)(extent / width);
+            view.originX = (float)(centerX - extent * 0.5);
+            view.originY = (float)(centerY - view.stepY * height * 0.5);
+            renderer.begin(width, height, view, values.data(), true);
+        }
+        refining = renderer.refine();
+        if (!refining) extent *= zoom;
+        colorEscapeValues(values, target);
+    }
+    
+private:
+    int width, height;
+    double zoom;
+    double centerX, centerY;   // float precision is all the batch kernels use
+    double extent;
+    std::vector<float> values;
+    EscapeTimeView view;
+    MarianiSilverRenderer renderer;
+    bool refining = false;
+};
+
+// Perturbation zoom towards options.center, options.zoom per frame
+class DeepZoomSequence {
+public:
+    explicit DeepZoomSequence(const HeadlessOptions& options)
+        : width(options.width), zoom(options.zoom), extent(options.extent),
+          values((size_t)options.width * options.height) {
+        view.centerX = parseDoubleDouble(options.centerX.c_str());
+        view.centerY = parseDoubleDouble(options.centerY.c_str());
+        view.maxIterations = options.iterations;
+    }
+    
+    void renderFrame(PixelBuffer& target) {
+        view.scale = extent / width;
+        renderer.render(target.getWidth(), target.getHeight(), view, values.data(), true);
+        colorEscapeValues(values, target);
+        extent *= zoom;
+    }
+    
+private:
+    int width;
+    double zoom;
+    double extent;
+    std::vector<float> values;
+    DeepZoomView view;
+    DeepZoomRenderer renderer;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    HeadlessOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    if (options.seeded) {
+        rng.seed(options.seed);
+    }
+    if (options.threads > 0) {
+        configureGlobalThreadPool(options.threads);
+    }
+
+    FILE* output = nullptr;
+    if (options.output == "-") {
+        output = stdout;
+    } else if (!options.output.empty()) {
+        output = std::fopen(options.output.c_str(), "wb");
+        if (!output) {
+            std::cerr << "Cannot open " << options.output << ": " << std::strerror(errno) << "\n";
+            return 1;
+        }
+    }
+
+    // Status goes to stderr so stdout can carry frame data
+    std::cerr << "Headless render: " << options.width << "x" << options.height
+              << ", " << options.frames << " frames, mode " << modeName(options.mode)
+              << ", raster kernels " << rasterKernels().name
+              << ", fractal kernels " << fractalKernels().name
+              << ", " << globalThreadPool().getWorkerCount() << " threads\n";
+
+    PixelBuffer pixelBuffer(options.width, options.height);
+    std::function<void(PixelBuffer&)> renderFrame;
+    std::unique_ptr<Scene> scene;
+    std::unique_ptr<ProgressiveMandelbrot> progressive;
+    std::unique_ptr<DeepZoomSequence> deepZoom;
+    
+    if (options.mode == HeadlessMode::Progressive) {
+        progressive = std::make_unique<ProgressiveMandelbrot>(options);
+        renderFrame = [&](PixelBuffer& target) { progressive->renderFrame(target); };
+    } else if (options.mode == HeadlessMode::DeepZoom) {
+        deepZoom = std::make_unique<DeepZoomSequence>(options);
+        renderFrame = [&](PixelBuffer& target) { deepZoom->renderFrame(target); };
+    } else {
+        scene = std::make_unique<Scene>(options.width, options.height);
+        if (options.seeded) {
+            // Background fractal recomputes finish at timing-dependent frames
+            scene->getFractalSystem().getFractalLayer().setAsync(false);
+        }
+        if (options.colorLut[0] > 0) {
+            scene->getFractalSystem().setColorLut(options.colorLut[0], options.colorLut[1], options.colorLut[2]);
+        }
+        scene->getWeirdVisualManager().setPopulationScale(options.population);
+        if (options.mode == HeadlessMode::Fractal) {
+            scene->toggleMode();
+        }
+        renderFrame = [&](PixelBuffer& target) { scene->renderFrame(target, options.deltaTime); };
+    }
+
+    const size_t frameBytes = (size_t)options.width * options.height * sizeof(uint32_t);
+    auto start = std::chrono::steady_clock::now();
+
+    for (int frame = 0; frame < options.frames; frame++) {
+        renderFrame(pixelBuffer);
+        if (output && std::fwrite(pixelBuffer.getData(), 1, frameBytes, output) != frameBytes) {
+            std::cerr << "Write failed at frame " << frame << "\n";
+            if (output != stdout) std::fclose(output);
+            return 1;
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (output && output != stdout) {
+        std::fclose(output);
+    } else if (output) {
+        std::fflush(output);
+    }
+
+    std::cerr << "Rendered " << options.frames << " frames in " << seconds << " s";
+    if (options.frames > 0) {
+        std::cerr << " (" << seconds * 1000.0 / options.frames << " ms/frame)";
+    }
+    std::cerr << "\n";
+    return 0;
+}
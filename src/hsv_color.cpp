@@ -0,0 +1,36 @@
+#include "hsv_color.h"
+#include <algorithm>
+
+void hsvToArgbRow(const float* h, const float* s, const float* v, uint32_t* out, int count) {
+    #pragma omp simd
+    for (int i = 0; i < count; i++) {
+        out[i] = hsvToArgb(h[i], s[i], v[i]);
+    }
+}
+
+HsvLut::HsvLut(int hueBuckets, int saturationLevels, int valueLevels)
+    : hueSteps(std::max(1, hueBuckets)), saturationSteps(std::max(2, saturationLevels)),
+      valueSteps(std::max(2, valueLevels)) {
+    saturationScale = (float)(saturationSteps - 1);
+    valueScale = (float)(valueSteps - 1);
+    table.resize((size_t)hueSteps * saturationSteps * valueSteps);
+
+    // Hue buckets are sampled at their centers, s and v at the exact levels
+    uint32_t* entry = table.data();
+    for (int hi = 0; hi < hueSteps; hi++) {
+        float h = (hi + 0.5f) * 360.0f / hueSteps;
+        for (int si = 0; si < saturationSteps; si++) {
+            for (int vi = 0; vi < valueSteps; vi++) {
+                *entry++ = hsvToArgb(h, si / saturationScale, vi / valueScale);
+            }
+        }
+    }
+}
+
+void HsvLut::convertRow(const float* h, const float* s, const float* v, uint32_t* out, int count) const {
+    const uint32_t* entries = table.data();
+    #pragma omp simd
+    for (int i = 0; i < count; i++) {
+        out[i] = entries[index(h[i], s[i], v[i])];
+    }
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// HSV -> ARGB8888 without the six-way sector branch: each channel is
+//   v - v * s * clamp(min(k, 4 - k), 0, 1),  k = (n + h / 60) mod 6,
+// with n = 5, 3, 1 for red, green and blue. Hue is in degrees and wraps, so
+// any value is valid; saturation and value are clamped to [0, 1]. Channels
+// are truncated to 8 bits like the old hsvToRgb.
+namespace hsvDetail {
+    // condition ? a : b through bit masks. Plain ?: gets split into separate
+    // paths for the constant cases, which keeps row loops from vectorizing.
+    inline float select(bool condition, float a, float b) {
+        int32_t mask = -(int32_t)condition;
+        int32_t aBits, bBits;
+        std::memcpy(&aBits, &a, sizeof(a));
+        std::memcpy(&bBits, &b, sizeof(b));
+        int32_t bits = (aBits & mask) | (bBits & ~mask);
+        float result;
+        std::memcpy(&result, &bits, sizeof(result));
+        return result;
+    }
+
+    // floor for |x| < 2^31 without SSE4.1 rounding instructions
+    inline float floorFast(float x) {
+        float t = (float)(int32_t)x;
+        return t - select(t > x, 1.0f, 0.0f);
+    }
+
+    inline float clamp01(float x) {
+        x = select(x > 0.0f, x, 0.0f);
+        return select(x < 1.0f, x, 1.0f);
+    }
+
+    inline uint32_t channel(float n, float sector, float v, float vs) {
+        float k = n + sector;
+        k = select(k >= 6.0f, k - 6.0f, k);
+        float w = clamp01(select(k < 4.0f - k, k, 4.0f - k));
+        return (uint32_t)(int32_t)((v - vs * w) * 255.0f);
+    }
+}
+
+inline uint32_t hsvToArgb(float h, float s, float v) {
+    float turns = h * (1.0f / 360.0f);
+    float sector = (turns - hsvDetail::floorFast(turns)) * 6.0f;  // [0, 6)
+    sector = hsvDetail::select(sector < 6.0f, sector, 0.0f);     // rounding up to 6 wraps
+    v = hsvDetail::clamp01(v);
+    float vs = v * hsvDetail::clamp01(s);
+    return 0xFF000000u | (hsvDetail::channel(5.0f, sector, v, vs) << 16) |
+           (hsvDetail::channel(3.0f, sector, v, vs) << 8) | hsvDetail::channel(1.0f, sector, v, vs);
+}
+
+// out[i] = hsvToArgb(h[i], s[i], v[i]); vectorized over the row
+void hsvToArgbRow(const float* h, const float* s, const float* v, uint32_t* out, int count);
+
+// Precomputed HSV -> ARGB table. Hue is quantized to hueSteps buckets over
+// [0, 360), saturation and value to saturationSteps / valueSteps levels
+// over [0, 1] (nearest level). A lookup is a few multiplies and one gather,
+// at the cost of hueSteps * saturationSteps * valueSteps * 4 bytes of table.
+// With the defaults (256 x 8 x 64, 512 KB) channels are within 20 / 255 of
+// hsvToArgb, almost all of it from the eight saturation levels.
+class HsvLut {
+public:
+    explicit HsvLut(int hueSteps = 256, int saturationSteps = 8, int valueSteps = 64);
+
+    uint32_t lookup(float h, float s, float v) const { return table[index(h, s, v)]; }
+    void convertRow(const float* h, const float* s, const float* v, uint32_t* out, int count) const;
+
+    int getHueSteps() const { return hueSteps; }
+    int getSaturationSteps() const { return saturationSteps; }
+    int getValueSteps() const { return valueSteps; }
+
+private:
+    int32_t index(float h, float s, float v) const {
+        float turns = h * (1.0f / 360.0f);
+        int32_t hi = (int32_t)((turns - hsvDetail::floorFast(turns)) * hueSteps);
+        hi &= -(int32_t)(hi < hueSteps);  // rounding up to hueSteps wraps
+        int32_t si = (int32_t)(hsvDetail::clamp01(s) * saturationScale + 0.5f);
+        int32_t vi = (int32_t)(hsvDetail::clamp01(v) * valueScale + 0.5f);
+        return (hi * saturationSteps + si) * valueSteps + vi;
+    }
+
+    int hueSteps, saturationSteps, valueSteps;
+    float saturationScale, valueScale;   // steps - 1
+    std::vector<uint32_t> table;
+};
@@ -0,0 +1,195 @@
+#include "log.h"
+#include <chrono>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+std::atomic<int> g_logLevel(LOG_LEVEL_INFO);
+
+namespace {
+    constexpr size_t kSlotCount = 1024;          // power of two
+    constexpr size_t kMessageBytes = 248;
+    constexpr auto kIdleSleep = std::chrono::milliseconds(2);
+    
+    const char* levelPrefix(LogLevel level) {
+        switch (level) {
+            case LogLevel::Trace: return "[trace] ";
+            case LogLevel::Debug: return "[debug] ";
+            case LogLevel::Warn: return "warning: ";
+            case LogLevel::Error: return "error: ";
+            default: return "";
+        }
+    }
+    
+    void writeLine(LogLevel level, const char* text) {
+        FILE* stream = level >= LogLevel::Warn ? stderr : stdout;
+        std::fputs(levelPrefix(level), stream);
+        std::fputs(text, stream);
+        std::fputc('\n', stream);
+    }
+    
+    // Bounded multi-producer queue (Vyukov). Each slot's sequence says whose
+    // turn it is: equal to the position when free for a producer, position + 1
+    // once the message is published for the single consumer.
+    struct Slot {
+        std::atomic<size_t> sequence;
+        LogLevel level;
+        char text[kMessageBytes];
+    };
+    
+    class LogWriter {
+    public:
+        LogWriter() : enqueuePos(0), dequeuePos(0), dropped(0), stopping(false), stopped(false) {
+            for (size_t i = 0; i < kSlotCount; i++) {
+                slots[i].sequence.store(i, std::memory_order_relaxed);
+            }
+            writer = std::thread(&LogWriter::run, this);
+        }
+        
+        ~LogWriter() { stop(); }
+        
+        void write(LogLevel level, const char* format, va_list args) {
+            if (stopped.load(std::memory_order_acquire)) {
+                char text[kMessageBytes];
+                std::vsnprintf(text, sizeof(text), format, args);
+                writeLine(level, text);
+                return;
+            }
+            
+            size_t pos = enqueuePos.load(std::memory_order_relaxed);
+            Slot* slot;
+            while (true) {
+                slot = &slots[pos & (kSlotCount - 1)];
+                size_t sequence = slot->sequence.load(std::memory_order_acquire);
+                intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+                if (diff == 0) {
+                    if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+                } else if (diff < 0) {
+                    dropped.fetch_add(1, std::memory_order_relaxed); // ring full
+                    return;
+                } else {
+                    pos = enqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+            
+            slot->level = level;
+            std::vsnprintf(slot->text, kMessageBytes, format, args);
+            slot->sequence.store(pos + 1, std::memory_order_release);
+        }
+        
+        void flush() {
+            if (stopped.load(std::memory_order_acquire)) return;
+            size_t target = enqueuePos.load(std::memory_order_acquire);
+            while (dequeuePos.load(std::memory_order_acquire) < target) {
+                std::this_thread::sleep_for(kIdleSleep);
+            }
+        }
+        
+        void stop() {
+            std::lock_guard<std::mutex> lock(stopMutex);
+            if (stopped.load(std::memory_order_relaxed)) return;
+            stopping.store(true, std::memory_order_release);
+            writer.join();
+            stopped.store(true, std::memory_order_release);
+        }
+        
+        size_t getDropped() const { return dropped.load(std::memory_order_relaxed); }
+        
+    private:
+        // Writes every published message; returns how many there were
+        size_t drain() {
+            size_t pos = dequeuePos.load(std::memory_order_relaxed);
+            size_t written = 0;
+            while (true) {
+                Slot& slot = slots[pos & (kSlotCount - 1)];
+                if (slot.sequence.load(std::memory_order_acquire) != pos + 1) break;
+                writeLine(slot.level, slot.text);
+                slot.sequence.store(pos + kSlotCount, std::memory_order_release);
+                pos++;
+                written++;
+            }
+            if (written > 0) {
+                std::fflush(stdout);
+                std::fflush(stderr);
+                dequeuePos.store(pos, std::memory_order_release);
+            }
+            return written;
+        }
+        
+        void run() {
+            while (true) {
+                bool finishing = stopping.load(std::memory_order_acquire);
+                if (drain() == 0) {
+                    // A claimed but unpublished slot keeps enqueuePos ahead,
+                    // so we only exit once every claimed message is written
+                    if (finishing && dequeuePos.load(std::memory_order_relaxed) ==
+                                     enqueuePos.load(std::memory_order_acquire)) {
+                        return;
+                    }
+                    std::this_thread::sleep_for(kIdleSleep);
+                }
+            }
+        }
+        
+        Slot slots[kSlotCount];
+        alignas(64) std::atomic<size_t> enqueuePos;
+        alignas(64) std::atomic<size_t> dequeuePos;
+        std::atomic<size_t> dropped;
+        std::atomic<bool> stopping;
+        std::atomic<bool> stopped;
+        std::mutex stopMutex;
+        std::thread writer;
+    };
+    
+    // Created on first use, so programs that never log never start the thread;
+    // the static destructor drains whatever is left at exit
+    LogWriter& logWriter() {
+        static LogWriter writer;
+        return writer;
+    }
+}
+
+void setLogLevel(LogLevel level) {
+    g_logLevel.store((int)level, std::memory_order_relaxed);
+}
+
+LogLevel getLogLevel() {
+    return (LogLevel)g_logLevel.load(std::memory_order_relaxed);
+}
+
+bool parseLogLevel(const char* name, LogLevel& level) {
+    static const struct { const char* name; LogLevel level; } kNames[] = {
+        {"trace", LogLevel::Trace}, {"debug", LogLevel::Debug}, {"info", LogLevel::Info},
+        {"warn", LogLevel::Warn}, {"error", LogLevel::Error}, {"off", LogLevel::Off},
+    };
+    if (!name) return false;
+    for (const auto& entry : kNames) {
+        if (std::strcmp(name, entry.name) == 0) {
+            level = entry.level;
+            return true;
+        }
+    }
+    return false;
+}
+
+void logWrite(LogLevel level, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    logWriter().write(level, format, args);
+    va_end(args);
+}
+
+void logFlush() {
+    logWriter().flush();
+}
+
+void logShutdown() {
+    logWriter().stop();
+}
+
+size_t getDroppedLogCount() {
+    return logWriter().getDropped();
+}
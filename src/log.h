@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+// Leveled logging that keeps stdio off the render thread. LOG_* formats the
+// message straight into a slot of a fixed-size lock-free ring; a background
+// thread drains the ring to stdout (stderr for warnings and errors).
+// A disabled level costs one relaxed atomic load, and levels below
+// LOG_COMPILE_LEVEL are compiled out. If the ring is full the message is
+// dropped rather than blocking the caller.
+#define LOG_LEVEL_TRACE 0
+#define LOG_LEVEL_DEBUG 1
+#define LOG_LEVEL_INFO  2
+#define LOG_LEVEL_WARN  3
+#define LOG_LEVEL_ERROR 4
+#define LOG_LEVEL_OFF   5
+
+#ifndef LOG_COMPILE_LEVEL
+#ifdef DEBUG
+#define LOG_COMPILE_LEVEL LOG_LEVEL_TRACE
+#else
+#define LOG_COMPILE_LEVEL LOG_LEVEL_DEBUG
+#endif
+#endif
+
+enum class LogLevel : int {
+    Trace = LOG_LEVEL_TRACE,
+    Debug = LOG_LEVEL_DEBUG,
+    Info = LOG_LEVEL_INFO,
+    Warn = LOG_LEVEL_WARN,
+    Error = LOG_LEVEL_ERROR,
+    Off = LOG_LEVEL_OFF
+};
+
+// Runtime threshold, Info by default
+extern std::atomic<int> g_logLevel;
+
+inline bool logEnabled(LogLevel level) {
+    return (int)level >= g_logLevel.load(std::memory_order_relaxed);
+}
+
+void setLogLevel(LogLevel level);
+LogLevel getLogLevel();
+// Accepts trace, debug, info, warn, error or off; returns false otherwise
+bool parseLogLevel(const char* name, LogLevel& level);
+
+void logWrite(LogLevel level, const char* format, ...) __attribute__((format(printf, 2, 3)));
+// Blocks until every message enqueued before the call has been written
+void logFlush();
+// Flushes and stops the writer thread; later messages are written directly
+void logShutdown();
+size_t getDroppedLogCount();
+
+#define LOG_AT(level, compileLevel, ...) \
+    do { \
+        if ((compileLevel) >= LOG_COMPILE_LEVEL && logEnabled(level)) logWrite(level, __VA_ARGS__); \
+    } while (0)
+
+#define LOG_TRACE(...) LOG_AT(LogLevel::Trace, LOG_LEVEL_TRACE, __VA_ARGS__)
+#define LOG_DEBUG(...) LOG_AT(LogLevel::Debug, LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define LOG_INFO(...)  LOG_AT(LogLevel::Info, LOG_LEVEL_INFO, __VA_ARGS__)
+#define LOG_WARN(...)  LOG_AT(LogLevel::Warn, LOG_LEVEL_WARN, __VA_ARGS__)
+#define LOG_ERROR(...) LOG_AT(LogLevel::Error, LOG_LEVEL_ERROR, __VA_ARGS__)
@@ -1,33 +1,42 @@
 #include <SDL.h>
-#include <iostream>
 #include <memory>
+#include <cstdlib>
 #include <cstring>
 
 // Include our modularized headers
 #include "utils.h"
-#include "fractals.h"
+#include "log.h"
 #include "pixelbuffer.h"
-#include "weird_entities.h"
-#include "fractal_system.h"
+#include "scene.h"
+#include "raster_kernels.h"
+#include "fractal_kernels.h"
+#include "thread_pool.h"
 
 int main(int argc, char** argv) {
-    std::cout << "Starting SDL initialization..." << std::flush;
+    // Log level comes from SR_LOG_LEVEL (trace, debug, info, warn, error, off);
+    // per-frame messages are at debug level
+    LogLevel logLevel;
+    if (parseLogLevel(std::getenv("SR_LOG_LEVEL"), logLevel)) {
+        setLogLevel(logLevel);
+    }
+    
+    LOG_INFO("Starting SDL initialization...");
     
     if (SDL_Init(SDL_INIT_VIDEO) != 0) {
-        std::cerr << "SDL_Init failed: " << SDL_GetError() << "\n";
+        LOG_ERROR("SDL_Init failed: %s", SDL_GetError());
         return -1;
     }
-    std::cout << "SDL initialized successfully\n" << std::flush;
+    LOG_INFO("SDL initialized successfully");
 
     // Get display information for fullscreen
     SDL_DisplayMode displayMode;
     if (SDL_GetCurrentDisplayMode(0, &displayMode) != 0) {
-        std::cerr << "SDL_GetCurrentDisplayMode failed: " << SDL_GetError() << "\n";
+        LOG_ERROR("SDL_GetCurrentDisplayMode failed: %s", SDL_GetError());
         SDL_Quit();
         return -1;
     }
     
-    std::cout << "Display resolution: " << displayMode.w << "x" << displayMode.h << "\n" << std::flush;
+    LOG_INFO("Display resolution: %dx%d", displayMode.w, displayMode.h);
 
     // Use display resolution for fullscreen, or default for windowed
     int WINDOW_WIDTH = displayMode.w;
@@ -38,7 +47,7 @@ int main(int argc, char** argv) {
     const int WINDOWED_WIDTH = 800;
     const int WINDOWED_HEIGHT = 600;
 
-    std::cout << "Creating fullscreen window..." << std::flush;
+    LOG_INFO("Creating fullscreen window...");
     SDL_Window* window = SDL_CreateWindow(
         "Software Renderer - Weird Visual Chaos Engine",
         SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
@@ -47,49 +56,58 @@ int main(int argc, char** argv) {
     );
 
     if (!window) {
-        std::cerr << "SDL_CreateWindow failed: " << SDL_GetError() << "\n";
+        LOG_ERROR("SDL_CreateWindow failed: %s", SDL_GetError());
         SDL_Quit();
         return -1;
     }
-    std::cout << "Fullscreen window created (" << WINDOW_WIDTH << "x" << WINDOW_HEIGHT << ")\n" << std::flush;
+    LOG_INFO("Fullscreen window created (%dx%d)", WINDOW_WIDTH, WINDOW_HEIGHT);
 
-    std::cout << "Creating renderer..." << std::flush;
+    LOG_INFO("Creating renderer...");
     SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
     if (!renderer) {
-        std::cerr << "SDL_CreateRenderer failed: " << SDL_GetError() << "\n";
+        LOG_ERROR("SDL_CreateRenderer failed: %s", SDL_GetError());
         SDL_DestroyWindow(window);
         SDL_Quit();
         return -1;
     }
-    std::cout << "Renderer created with VSync enabled\n" << std::flush;
+    LOG_INFO("Renderer created with VSync enabled");
 
-    std::cout << "Creating texture..." << std::flush;
+    LOG_INFO("Creating texture...");
     SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888,
                                            SDL_TEXTUREACCESS_STREAMING,
                                            WINDOW_WIDTH, WINDOW_HEIGHT);
     if (!texture) {
-        std::cerr << "SDL_CreateTexture failed: " << SDL_GetError() << "\n";
+        LOG_ERROR("SDL_CreateTexture failed: %s", SDL_GetError());
         SDL_DestroyRenderer(renderer);
         SDL_DestroyWindow(window);
         SDL_Quit();
         return -1;
     }
-    std::cout << "Texture created (" << WINDOW_WIDTH << "x" << WINDOW_HEIGHT << ")\n" << std::flush;
+    LOG_INFO("Texture created (%dx%d)", WINDOW_WIDTH, WINDOW_HEIGHT);
 
     // Create our pixel buffer with current resolution
-    std::cout << "Creating pixel buffer..." << std::flush;
+    // Frames are rendered straight into the locked texture unless
+    // SR_PRESENT=copy asks for the old render-then-copy path
+    const char* presentMode = std::getenv("SR_PRESENT");
+    bool directPresent = !(presentMode && std::strcmp(presentMode, "copy") == 0);
+    
+    LOG_INFO("Creating pixel buffer...");
     PixelBuffer pixelBuffer(WINDOW_WIDTH, WINDOW_HEIGHT);
-    std::cout << "Pixel buffer created\n" << std::flush;
+    LOG_INFO("Pixel buffer created");
+    LOG_INFO("Raster kernels: %s", rasterKernels().name);
+    LOG_INFO("Fractal kernels: %s", fractalKernels().name);
+    LOG_INFO("Render threads: %zu", globalThreadPool().getWorkerCount());
+    LOG_INFO("Presentation: %s", directPresent ? "direct to texture" : "copy from pixel buffer");
 
-    std::cout << "Software Renderer initialized in fullscreen!\n";
-    std::cout << "Current resolution: " << WINDOW_WIDTH << "x" << WINDOW_HEIGHT << "\n" << std::flush;
-    std::cout << "Controls:\n";
-    std::cout << "  ESC - Exit\n";
-    std::cout << "  F11 - Toggle fullscreen/windowed\n";
-    std::cout << "  F - Toggle fullscreen/windowed\n";
-    std::cout << "  M - Toggle between Weird Chaos and Fractal/Game of Life modes\n";
-    std::cout << "  SPACE - Force chaos injection (in fractal mode)\n";
-    std::cout << "  R - Reset current mode\n" << std::flush;
+    LOG_INFO("Software Renderer initialized in fullscreen!");
+    LOG_INFO("Current resolution: %dx%d", WINDOW_WIDTH, WINDOW_HEIGHT);
+    LOG_INFO("Controls:");
+    LOG_INFO("  ESC - Exit");
+    LOG_INFO("  F11 - Toggle fullscreen/windowed");
+    LOG_INFO("  F - Toggle fullscreen/windowed");
+    LOG_INFO("  M - Toggle between Weird Chaos and Fractal/Game of Life modes");
+    LOG_INFO("  SPACE - Force chaos injection (in fractal mode)");
+    LOG_INFO("  R - Reset current mode");
 
     bool running = true;
     bool needsRedraw = true;
@@ -99,22 +117,13 @@ int main(int argc, char** argv) {
     float rotation_time = 0.0f;
     uint32_t last_time = SDL_GetTicks();
     
-    std::cout << "Creating visual systems..." << std::flush;
+    LOG_INFO("Creating visual systems...");
     
-    // Create weird visual manager
-    WeirdVisualManager weirdVisualManager;
-
-    // Create fractal/game of life system
-    FractalGameOfLifeSystem fractalSystem(WINDOW_WIDTH, WINDOW_HEIGHT);
+    // Create both visual systems (weird entities and fractal/game of life)
+    Scene scene(WINDOW_WIDTH, WINDOW_HEIGHT);
     
-    // Set global pointer for injection functions
-    g_fractalSystem = &fractalSystem;
-
-    // Mode toggle: true=Weird Chaos, false=Fractal/Game of Life
-    bool isWeirdChaosMode = true;
-
-    std::cout << "Initialized dual-mode system!\n";
-    std::cout << "Starting in Weird Chaos Mode\n" << std::flush;
+    LOG_INFO("Initialized dual-mode system!");
+    LOG_INFO("Starting in Weird Chaos Mode");
 
     // Function to toggle fullscreen
     auto toggleFullscreen = [&]() {
@@ -134,13 +143,13 @@ int main(int argc, char** argv) {
             pixelBuffer = PixelBuffer(WINDOWED_WIDTH, WINDOWED_HEIGHT);
             
             // Resize fractal system to match new resolution
-            fractalSystem.resize(WINDOWED_WIDTH, WINDOWED_HEIGHT);
+            scene.resize(WINDOWED_WIDTH, WINDOWED_HEIGHT);
             
             WINDOW_WIDTH = WINDOWED_WIDTH;
             WINDOW_HEIGHT = WINDOWED_HEIGHT;
             isFullscreen = false;
             
-            std::cout << "Switched to windowed mode (" << WINDOW_WIDTH << "x" << WINDOW_HEIGHT << ")\n" << std::flush;
+            LOG_INFO("Switched to windowed mode (%dx%d)", WINDOW_WIDTH, WINDOW_HEIGHT);
         } else {
             // Switch to fullscreen mode
             SDL_SetWindowFullscreen(window, SDL_WINDOW_FULLSCREEN_DESKTOP);
@@ -155,31 +164,33 @@ int main(int argc, char** argv) {
             pixelBuffer = PixelBuffer(displayMode.w, displayMode.h);
             
             // Resize fractal system to match new resolution
-            fractalSystem.resize(displayMode.w, displayMode.h);
+            scene.resize(displayMode.w, displayMode.h);
             
             WINDOW_WIDTH = displayMode.w;
             WINDOW_HEIGHT = displayMode.h;
             isFullscreen = true;
             
-            std::cout << "Switched to fullscreen mode (" << WINDOW_WIDTH << "x" << WINDOW_HEIGHT << ")\n" << std::flush;
+            LOG_INFO("Switched to fullscreen mode (%dx%d)", WINDOW_WIDTH, WINDOW_HEIGHT);
         }
         needsRedraw = true;
     };
 
     // Function to toggle modes
     auto toggleMode = [&]() {
-        isWeirdChaosMode = !isWeirdChaosMode;
-        if (isWeirdChaosMode) {
-            std::cout << "Switched to Weird Chaos Mode - 3D entities with chaotic physics\n" << std::flush;
+        scene.toggleMode();
+        if (scene.isWeirdChaosMode()) {
+            LOG_INFO("Switched to Weird Chaos Mode - 3D entities with chaotic physics");
         } else {
-            std::cout << "Switched to Fractal/Game of Life Mode - Current: " << fractalSystem.getCurrentModeName() << "\n" << std::flush;
+            LOG_INFO("Switched to Fractal/Game of Life Mode - Current: %s", scene.getFractalSystem().getCurrentModeName().c_str());
         }
         needsRedraw = true;
     };
 
-    // Function to draw the scene
+    // Function to draw the scene and put it on screen. By default the frame
+    // is rendered straight into the locked texture; with SR_PRESENT=copy it
+    // goes to pixelBuffer first and is copied over a row at a time.
     auto drawScene = [&]() {
-        std::cout << "\n=== DRAWING SCENE (" << WINDOW_WIDTH << "x" << WINDOW_HEIGHT << ") ===\n" << std::flush;
+        LOG_DEBUG("=== DRAWING SCENE (%dx%d) ===", WINDOW_WIDTH, WINDOW_HEIGHT);
         
         // Update animation time
         uint32_t current_time = SDL_GetTicks();
@@ -187,107 +198,52 @@ int main(int argc, char** argv) {
         last_time = current_time;
         rotation_time += delta_time;
         
-        if (isWeirdChaosMode) {
-            std::cout << "Mode: Weird Chaos - Rendering 3D entities\n" << std::flush;
-            
-            // Clear with a randomly shifting dark background
-            uint32_t bgColor = 0xFF000000 | 
-                              (randomInt(5, 25) << 16) | 
-                              (randomInt(5, 25) << 8) | 
-                              randomInt(5, 25);
-            pixelBuffer.clear(bgColor);
-            
-            // Update weird visual entities
-            weirdVisualManager.update(delta_time);
-            
-            // Set up perspective projection matrix with current aspect ratio
-            float fov = 45.0f * M_PI / 180.0f; // 45 degrees in radians
-            float aspect = (float)WINDOW_WIDTH / WINDOW_HEIGHT;
-            Matrix4x4 projection = Matrix4x4::perspective(fov, aspect, 0.1f, 100.0f);
-            
-            // Render weird visual entities first (background layer)
-            auto weirdTriangles = weirdVisualManager.getAllTriangles();
-            std::cout << "Rendering " << weirdTriangles.size() << " weird triangles from " << weirdVisualManager.getEntityCount() << " entities...\n" << std::flush;
-            
-            for (const auto& triangle : weirdTriangles) {
-                // Transform weird triangle
-                Matrix4x4 weirdTransform = projection;
-                Triangle3D transformed = triangle.transform(weirdTransform);
-                
-                // Check if triangle is facing towards camera
-                Vec3 normal = transformed.getNormal();
-                if (normal.z > 0) {
-                    pixelBuffer.render3DTriangle(transformed, WINDOW_WIDTH, WINDOW_HEIGHT);
-                }
-            }
-            
-            // Add some chaos background effects (scale with resolution)
-            if (randomFloat(0, 1) < 0.1f) { // 10% chance per frame
-                // Random streaks across screen
-                int numStreaks = randomInt(1, 5);
-                for (int i = 0; i < numStreaks; i++) {
-                    pixelBuffer.drawLine(
-                        randomInt(0, WINDOW_WIDTH), randomInt(0, WINDOW_HEIGHT),
-                        randomInt(0, WINDOW_WIDTH), randomInt(0, WINDOW_HEIGHT),
-                        randomColor()
-                    );
-                }
-            }
-            
-            // Occasionally add screen-wide effects (scale with resolution)
-            if (randomFloat(0, 1) < 0.05f) { // 5% chance per frame
-                switch (randomInt(0, 2)) {
-                    case 0: // Random dots
-                        for (int i = 0; i < randomInt(50, 200); i++) {
-                            pixelBuffer.setPixel(randomInt(0, WINDOW_WIDTH), randomInt(0, WINDOW_HEIGHT), randomColor());
-                        }
-                        break;
-                    case 1: // Random rectangles
-                        for (int i = 0; i < randomInt(3, 8); i++) {
-                            int maxSize = std::min(WINDOW_WIDTH, WINDOW_HEIGHT) / 20; // Scale with resolution
-                            int x = randomInt(0, WINDOW_WIDTH - maxSize);
-                            int y = randomInt(0, WINDOW_HEIGHT - maxSize);
-                            pixelBuffer.fillRectangle(x, y, randomInt(10, maxSize), randomInt(10, maxSize), randomColor());
-                        }
-                        break;
-                }
-            }
+        if (scene.isWeirdChaosMode()) {
+            LOG_DEBUG("Mode: Weird Chaos - Rendering 3D entities");
+        } else {
+            LOG_DEBUG("Mode: Fractal/Game of Life - Current: %s", scene.getFractalSystem().getCurrentModeName().c_str());
+        }
+        
+        void* texturePixels;
+        int pitch;
+        if (SDL_LockTexture(texture, NULL, &texturePixels, &pitch) != 0) {
+            // Keep the simulation going even if this frame can't be shown
+            LOG_DEBUG("SDL_LockTexture failed: %s", SDL_GetError());
+            scene.renderFrame(pixelBuffer, delta_time);
+            return;
+        }
+        
+        if (directPresent) {
+            PixelBuffer textureBuffer = PixelBuffer::wrap((uint32_t*)texturePixels, WINDOW_WIDTH, WINDOW_HEIGHT, pitch / 4);
+            scene.renderFrame(textureBuffer, delta_time);
         } else {
-            // Fractal/Game of Life mode
-            std::cout << "Mode: Fractal/Game of Life - Current: " << fractalSystem.getCurrentModeName() << "\n" << std::flush;
-            pixelBuffer.clear(0xFF000000); // Black background
-            fractalSystem.update(delta_time);
-            fractalSystem.render(pixelBuffer);
+            scene.renderFrame(pixelBuffer, delta_time);
+            const uint32_t* source = pixelBuffer.getData();
+            for (int y = 0; y < WINDOW_HEIGHT; y++) {
+                memcpy((uint8_t*)texturePixels + (size_t)y * pitch, source + (size_t)y * WINDOW_WIDTH, WINDOW_WIDTH * 4);
+            }
         }
+        SDL_UnlockTexture(texture);
         
-        std::cout << "=== SCENE DRAWING COMPLETE ===\n\n" << std::flush;
+        if (scene.isWeirdChaosMode()) {
+            LOG_DEBUG("Rendered %zu weird triangles from %zu entities", scene.getLastTriangleCount(), scene.getWeirdVisualManager().getEntityCount());
+        }
+        
+        SDL_RenderClear(renderer);
+        SDL_RenderCopy(renderer, texture, NULL, NULL);
+        SDL_RenderPresent(renderer);
+        
+        LOG_DEBUG("=== SCENE DRAWING COMPLETE ===");
     };
 
-    std::cout << "About to call drawScene...\n" << std::flush;
-    drawScene();
-    std::cout << "drawScene completed, about to render...\n" << std::flush;
-    
     // Initial render
-    void* texturePixels;
-    int pitch;
-    std::cout << "Locking texture...\n" << std::flush;
-    SDL_LockTexture(texture, NULL, &texturePixels, &pitch);
-    
-    std::cout << "Copying pixel data...\n" << std::flush;
-    memcpy(texturePixels, pixelBuffer.getData(), WINDOW_WIDTH * WINDOW_HEIGHT * 4);
-    
-    std::cout << "Unlocking texture...\n" << std::flush;
-    SDL_UnlockTexture(texture);
-
-    std::cout << "Rendering to screen...\n" << std::flush;
-    SDL_RenderClear(renderer);
-    SDL_RenderCopy(renderer, texture, NULL, NULL);
-    SDL_RenderPresent(renderer);
-    std::cout << "Initial render complete - you should now see shapes on screen!\n" << std::flush;
+    LOG_DEBUG("About to call drawScene...");
+    drawScene();
+    LOG_INFO("Initial render complete - you should now see shapes on screen!");
     
-    std::cout << "Entering main loop (press ESC to exit, F11 or F to toggle fullscreen, M to toggle modes)...\n" << std::flush;
+    LOG_INFO("Entering main loop (press ESC to exit, F11 or F to toggle fullscreen, M to toggle modes)...");
     
-    std::cout << "Entering main event loop...\n" << std::flush;
+    LOG_DEBUG("Entering main event loop...");
     
     while (running) {
         // Process events
@@ -314,21 +270,21 @@ int main(int argc, char** argv) {
                             
                         case SDLK_SPACE:
                             // Force chaos injection in fractal mode
-                            if (!isWeirdChaosMode) {
-                                fractalSystem.initialize(); // Reinitialize with new random patterns
-                                std::cout << "Chaos injected! New pattern: " << fractalSystem.getCurrentModeName() << "\n" << std::flush;
+                            if (!scene.isWeirdChaosMode()) {
+                                scene.getFractalSystem().initialize(); // Reinitialize with new random patterns
+                                LOG_INFO("Chaos injected! New pattern: %s", scene.getFractalSystem().getCurrentModeName().c_str());
                             }
                             needsRedraw = true;
                             break;
                             
                         case SDLK_r:
                             // Reset everything
-                            if (isWeirdChaosMode) {
-                                weirdVisualManager = WeirdVisualManager();
-                                std::cout << "Weird entities reset!\n" << std::flush;
+                            if (scene.isWeirdChaosMode()) {
+                                scene.resetWeirdEntities();
+                                LOG_INFO("Weird entities reset!");
                             } else {
-                                fractalSystem.initialize();
-                                std::cout << "Fractal system reset!\n" << std::flush;
+                                scene.getFractalSystem().initialize();
+                                LOG_INFO("Fractal system reset!");
                             }
                             needsRedraw = true;
                             break;
@@ -349,20 +305,6 @@ int main(int argc, char** argv) {
         
         if (needsRedraw) {
             drawScene();
-            
-            // Lock texture and copy pixel data
-            void* texturePixels;
-            int pitch;
-            if (SDL_LockTexture(texture, NULL, &texturePixels, &pitch) == 0) {
-                memcpy(texturePixels, pixelBuffer.getData(), WINDOW_WIDTH * WINDOW_HEIGHT * 4);
-                SDL_UnlockTexture(texture);
-                
-                // Render to screen
-                SDL_RenderClear(renderer);
-                SDL_RenderCopy(renderer, texture, NULL, NULL);
-                SDL_RenderPresent(renderer);
-            }
-            
             needsRedraw = false;
         }
         
@@ -370,12 +312,13 @@ int main(int argc, char** argv) {
         SDL_Delay(1); // ~1000 FPS cap, but VSync will limit to monitor refresh rate
     }
 
-    std::cout << "Cleaning up...\n" << std::flush;
+    LOG_INFO("Cleaning up...");
     SDL_DestroyTexture(texture);
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     SDL_Quit();
     
-    std::cout << "Software Renderer terminated successfully!\n" << std::flush;
+    LOG_INFO("Software Renderer terminated successfully!");
+    logShutdown();
     return 0;
 }
@@ -0,0 +1,144 @@
+#include "mariani_silver.h"
+#include "fractal_kernels.h"
+#include "thread_pool.h"
+#include <algorithm>
+
+namespace {
+    constexpr int kChunk = 4096;  // points per batch kernel call
+}
+
+void MarianiSilverRenderer::begin(int w, int h, const EscapeTimeView& v, float* output, bool parallelPasses) {
+    width = w;
+    height = h;
+    view = v;
+    values = output;
+    parallel = parallelPasses;
+    passCount = 0;
+    evaluatedCount = 0;
+    done.assign((size_t)w * h, 0);
+    pending.clear();
+    
+    // Tiles share their edge lines, so neighboring borders are evaluated once
+    for (int y0 = 0; y0 < h - 1 || y0 == 0; y0 += kInitialTile) {
+        for (int x0 = 0; x0 < w - 1 || x0 == 0; x0 += kInitialTile) {
+            pending.push_back({ x0, y0, std::min(x0 + kInitialTile, w - 1), std::min(y0 + kInitialTile, h - 1) });
+        }
+    }
+}
+
+void MarianiSilverRenderer::queuePoint(int x, int y) {
+    size_t index = (size_t)y * width + x;
+    if (!done[index]) {
+        done[index] = 1;  // set now so shared border pixels are queued once
+        queued.push_back((int32_t)index);
+        xs.push_back(view.originX + view.stepX * x);
+        ys.push_back(view.originY + view.stepY * y);
+    }
+}
+
+void MarianiSilverRenderer::evaluateQueued() {
+    int count = (int)queued.size();
+    if (count == 0) return;
+    results.resize(count);
+    
+    auto evaluateChunk = [this, count](size_t chunk, size_t) {
+        int begin = (int)chunk * kChunk;
+        int n = std::min(kChunk, count - begin);
+        const float* cx = xs.data() + begin;
+        const float* cy = ys.data() + begin;
+        float* out = results.data() + begin;
+        switch (view.fractal) {
+            case EscapeFractal::Mandelbrot: computeMandelbrotRow(cx, cy, out, n, view.options); break;
+            case EscapeFractal::Julia: computeJuliaRow(cx, cy, out, n, view.juliaX, view.juliaY, view.options); break;
+            case EscapeFractal::BurningShip: computeBurningShipRow(cx, cy, out, n, view.options); break;
+            case EscapeFractal::Tricorn: computeTricornRow(cx, cy, out, n, view.options); break;
+            case EscapeFractal::Phoenix: computePhoenixRow(cx, cy, out, n, view.options); break;
+        }
+        for (int i = 0; i < n; i++) {
+            values[queued[begin + i]] = out[i];
+        }
+    };
+    size_t chunks = (count + kChunk - 1) / kChunk;
+    if (parallel) {
+        globalThreadPool().parallelFor(chunks, evaluateChunk);
+    } else {
+        for (size_t chunk = 0; chunk < chunks; chunk++) evaluateChunk(chunk, 0);
+    }
+    
+    evaluatedCount += count;
+    queued.clear();
+    xs.clear();
+    ys.clear();
+}
+
+bool MarianiSilverRenderer::borderIsUniform(const Rect& rect) const {
+    float value = values[(size_t)rect.y0 * width + rect.x0];
+    const float* top = values + (size_t)rect.y0 * width;
+    const float* bottom = values + (size_t)rect.y1 * width;
+    for (int x = rect.x0; x <= rect.x1; x++) {
+        if (top[x] != value || bottom[x] != value) return false;
+    }
+    for (int y = rect.y0 + 1; y < rect.y1; y++) {
+        const float* row = values + (size_t)y * width;
+        if (row[rect.x0] != value || row[rect.x1] != value) return false;
+    }
+    return true;
+}
+
+void MarianiSilverRenderer::fillInterior(const Rect& rect, float value, bool final) {
+    for (int y = rect.y0 + 1; y < rect.y1; y++) {
+        float* row = values + (size_t)y * width;
+        uint8_t* doneRow = done.data() + (size_t)y * width;
+        for (int x = rect.x0 + 1; x < rect.x1; x++) {
+            if (!doneRow[x]) {
+                row[x] = value;
+                doneRow[x] = final;
+            }
+        }
+    }
+}
+
+bool MarianiSilverRenderer::refine() {
+    if (pending.empty()) return false;
+    passCount++;
+    
+    // Evaluate every border pixel that is not known yet. Each edge is queued
+    // as one run: a SIMD block costs as much as its slowest lane, so lanes
+    // should hold neighboring pixels rather than opposite sides of a rectangle
+    for (const Rect& rect : pending) {
+        for (int x = rect.x0; x <= rect.x1; x++) queuePoint(x, rect.y0);
+        for (int x = rect.x0; x <= rect.x1; x++) queuePoint(x, rect.y1);
+        for (int y = rect.y0 + 1; y < rect.y1; y++) queuePoint(rect.x0, y);
+        for (int y = rect.y0 + 1; y < rect.y1; y++) queuePoint(rect.x1, y);
+    }
+    evaluateQueued();
+    
+    // Fill uniform rectangles, split the rest
+    next.clear();
+    for (const Rect& rect : pending) {
+        if (rect.x1 - rect.x0 < 2 || rect.y1 - rect.y0 < 2) continue;  // no interior
+        
+        float corner = values[(size_t)rect.y0 * width + rect.x0];
+        if (borderIsUniform(rect)) {
+            fillInterior(rect, corner, true);
+        } else if (rect.x1 - rect.x0 <= kMinSplit || rect.y1 - rect.y0 <= kMinSplit) {
+            for (int y = rect.y0 + 1; y < rect.y1; y++) {
+                for (int x = rect.x0 + 1; x < rect.x1; x++) {
+                    queuePoint(x, y);
+                }
+            }
+        } else {
+            fillInterior(rect, corner, false);  // preview until the children resolve
+            int midX = (rect.x0 + rect.x1) / 2;
+            int midY = (rect.y0 + rect.y1) / 2;
+            next.push_back({ rect.x0, rect.y0, midX, midY });
+            next.push_back({ midX, rect.y0, rect.x1, midY });
+            next.push_back({ rect.x0, midY, midX, rect.y1 });
+            next.push_back({ midX, midY, rect.x1, rect.y1 });
+        }
+    }
+    evaluateQueued();
+    
+    pending.swap(next);
+    return !pending.empty();
+}
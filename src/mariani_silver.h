@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "fractals.h"
+
+// Escape-time fractal over a pixel grid: pixel (x, y) maps to
+// (originX + x * stepX, originY + y * stepY)
+struct EscapeTimeView {
+    EscapeFractal fractal;
+    EscapeTimeOptions options;
+    float juliaX, juliaY;        // Julia parameter (EscapeFractal::Julia only)
+    float originX, originY;
+    float stepX, stepY;
+};
+
+// Mariani-Silver renderer on top of the batch escape-time kernels. The image
+// starts as a grid of tiles; each refine() pass evaluates the borders of the
+// current rectangles, flood-fills every rectangle whose border has a single
+// value and splits the others in four for the next pass. Small rectangles
+// are evaluated outright. Undecided rectangles are previewed with their
+// corner value, so the image is complete (if blocky) after every pass and
+// can be shown before refinement finishes (headless --mode progressive
+// outputs every pass).
+//
+// Filling from the border is exact for fractals with connected level sets
+// (Mandelbrot, connected Julia sets); elsewhere it can miss small islands.
+// It only saves time where the flat regions are expensive, i.e. interiors at
+// high iteration counts; border pixels are scattered, so SIMD blocks
+// diverge more than they do over plain rows.
+class MarianiSilverRenderer {
+public:
+    // Starts a render into output (width * height floats, row-major). With
+    // parallel set, each pass spreads its evaluations over globalThreadPool().
+    void begin(int width, int height, const EscapeTimeView& view, float* output, bool parallel);
+    
+    // Runs one coarse-to-fine pass; returns false once the image is final
+    bool refine();
+    void renderAll() { while (refine()) {} }
+    
+    int getPassCount() const { return passCount; }
+    size_t getEvaluatedCount() const { return evaluatedCount; }
+    
+private:
+    struct Rect { int x0, y0, x1, y1; };  // inclusive corners, border included
+    
+    static constexpr int kInitialTile = 32;
+    static constexpr int kMinSplit = 6;    // rectangles this small are evaluated outright
+    
+    void queuePoint(int x, int y);
+    void evaluateQueued();
+    bool borderIsUniform(const Rect& rect) const;
+    void fillInterior(const Rect& rect, float value, bool final);
+    
+    int width = 0, height = 0;
+    EscapeTimeView view = {};
+    float* values = nullptr;
+    bool parallel = false;
+    
+    std::vector<uint8_t> done;            // 1 once a pixel holds its final value
+    std::vector<Rect> pending, next;
+    std::vector<int32_t> queued;          // pixel indices to evaluate this pass
+    std::vector<float> xs, ys, results;
+    int passCount = 0;
+    size_t evaluatedCount = 0;
+};
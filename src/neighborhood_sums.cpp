@@ -0,0 +1,83 @@
+#include "neighborhood_sums.h"
+
+void NeighborhoodSums::begin(const Grid2D<float>& grid, int firstRow) {
+    source = &grid;
+    width = grid.getWidth();
+    prefixStride = width + 2 * kHaloCols;
+
+    column3.resize(width + 2 * kRadius);
+    column5.resize(width + 2 * kRadius);
+    ring3Sums.resize(width);
+    ring5Sums.resize(width);
+    diagonalSums.resize(width);
+    mainDiagonal.resize((size_t)kRingRows * prefixStride);
+    antiDiagonal.resize((size_t)kRingRows * prefixStride);
+
+    // Diagonal prefixes restart one row above the first window, so a band of
+    // rows never depends on rows outside its own reach
+    int startRow = firstRow - kRadius - 1;
+    const float* g = grid.row(startRow);
+    double* main = mainPrefix(startRow);
+    double* anti = antiPrefix(startRow);
+    for (int x = -kHaloCols; x < width + kHaloCols; x++) {
+        main[x] = g[x];
+        anti[x] = g[x];
+    }
+    nextPrefixRow = startRow + 1;
+}
+
+void NeighborhoodSums::advancePrefixRow(int r) {
+    const float* g = source->row(r);
+    double* main = mainPrefix(r);
+    double* anti = antiPrefix(r);
+    const double* mainAbove = mainPrefix(r - 1);
+    const double* antiAbove = antiPrefix(r - 1);
+
+    // Main diagonals run down-right, anti diagonals down-left; chains that
+    // enter from outside the stored columns start at zero (halo cells are 0)
+    main[-kHaloCols] = g[-kHaloCols];
+    for (int x = -kHaloCols + 1; x < width + kHaloCols; x++) {
+        main[x] = g[x] + mainAbove[x - 1];
+    }
+    anti[width + kHaloCols - 1] = g[width + kHaloCols - 1];
+    for (int x = -kHaloCols; x < width + kHaloCols - 1; x++) {
+        anti[x] = g[x] + antiAbove[x + 1];
+    }
+}
+
+void NeighborhoodSums::computeRow(int y) {
+    while (nextPrefixRow <= y + kRadius) {
+        advancePrefixRow(nextPrefixRow++);
+    }
+
+    const float* up2 = source->row(y - 2);
+    const float* up1 = source->row(y - 1);
+    const float* mid = source->row(y);
+    const float* down1 = source->row(y + 1);
+    const float* down2 = source->row(y + 2);
+
+    // Vertical pass over the row plus kRadius columns either side
+    float* col3 = column3.data() + kRadius;
+    float* col5 = column5.data() + kRadius;
+    for (int x = -kRadius; x < width + kRadius; x++) {
+        float inner = up1[x] + mid[x] + down1[x];
+        col3[x] = inner;
+        col5[x] = inner + up2[x] + down2[x];
+    }
+
+    // Horizontal pass, then remove the center cell
+    const double* mainEnd = mainPrefix(y + kRadius);
+    const double* mainStart = mainPrefix(y - kRadius - 1);
+    const double* antiEnd = antiPrefix(y + kRadius);
+    const double* antiStart = antiPrefix(y - kRadius - 1);
+    for (int x = 0; x < width; x++) {
+        float box3 = col3[x - 1] + col3[x] + col3[x + 1];
+        float box5 = col5[x - 2] + col5[x - 1] + col5[x] + col5[x + 1] + col5[x + 2];
+        ring3Sums[x] = box3 - mid[x];
+        ring5Sums[x] = box5 - mid[x];
+
+        double main = mainEnd[x + kRadius] - mainStart[x - kRadius - 1];
+        double anti = antiEnd[x - kRadius] - antiStart[x + kRadius + 1];
+        diagonalSums[x] = (float)(main + anti - 2.0 * mid[x]);
+    }
+}
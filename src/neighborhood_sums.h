@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+#include "grid2d.h"
+
+// Streaming neighborhood sums for the Game of Life stencil. For each cell of
+// a row it produces, excluding the cell itself:
+//   ring3     - sum of the 3x3 box
+//   ring5     - sum of the 5x5 box
+//   diagonals - sum of both diagonals out to radius 2 (8 cells)
+// Box sums are separable: 3- and 5-row column sums, then 3- and 5-wide row
+// sums, so each cell costs a constant handful of adds. Diagonals come from
+// prefix sums running along each diagonal, kept in double precision in a
+// six-row ring, so a window is the difference of two prefix values.
+// Cells outside the grid read the grid's zeroed halo (radius <= Grid2D::kHalo).
+class NeighborhoodSums {
+public:
+    // Prepares to stream rows firstRow, firstRow + 1, ... of grid
+    void begin(const Grid2D<float>& grid, int firstRow);
+    // Computes the sums for row y; rows must be visited consecutively
+    void computeRow(int y);
+
+    const float* ring3() const { return ring3Sums.data(); }
+    const float* ring5() const { return ring5Sums.data(); }
+    const float* diagonals() const { return diagonalSums.data(); }
+
+private:
+    static constexpr int kRadius = 2;
+    static constexpr int kRingRows = 2 * kRadius + 2;
+
+    void advancePrefixRow(int r);
+    double* mainPrefix(int r) { return mainDiagonal.data() + prefixSlot(r) * prefixStride + kHaloCols; }
+    double* antiPrefix(int r) { return antiDiagonal.data() + prefixSlot(r) * prefixStride + kHaloCols; }
+    int prefixSlot(int r) const { return ((r % kRingRows) + kRingRows) % kRingRows; }
+
+    static constexpr int kHaloCols = Grid2D<float>::kHalo;
+
+    const Grid2D<float>* source = nullptr;
+    int width = 0;
+    int nextPrefixRow = 0;
+    int prefixStride = 0;
+
+    std::vector<float> column3, column5;   // include kRadius halo columns each side
+    std::vector<float> ring3Sums, ring5Sums, diagonalSums;
+    std::vector<double> mainDiagonal, antiDiagonal;
+};
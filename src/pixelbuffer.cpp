@@ -1,59 +1,65 @@
 #include "pixelbuffer.h"
+#include "raster_kernels.h"
 #include <algorithm>
+#include <cstdint>
+#include <cstdlib>
 #include <cstring>
 
-// Color struct implementations
-PixelBuffer::Color::Color(uint32_t argb) {
-    a = ((argb >> 24) & 0xFF) / 255.0f;
-    r = ((argb >> 16) & 0xFF) / 255.0f;
-    g = ((argb >> 8) & 0xFF) / 255.0f;
-    b = (argb & 0xFF) / 255.0f;
+// PixelBuffer implementations
+PixelBuffer::PixelBuffer(int w, int h) : width(w), height(h), stride(w) {
+    storage.resize((size_t)w * h);
+    pixels = storage.data();
 }
 
-PixelBuffer::Color::Color(float red, float green, float blue, float alpha) 
-    : r(red), g(green), b(blue), a(alpha) {}
-
-uint32_t PixelBuffer::Color::toARGB() const {
-    uint8_t ai = (uint8_t)(a * 255.0f);
-    uint8_t ri = (uint8_t)(r * 255.0f);
-    uint8_t gi = (uint8_t)(g * 255.0f);
-    uint8_t bi = (uint8_t)(b * 255.0f);
-    return (ai << 24) | (ri << 16) | (gi << 8) | bi;
-}
+PixelBuffer::PixelBuffer(uint32_t* external, int w, int h, int rowStride)
+    : pixels(external), width(w), height(h), stride(rowStride) {}
 
-PixelBuffer::Color PixelBuffer::Color::operator+(const Color& other) const {
-    return Color(r + other.r, g + other.g, b + other.b, a + other.a);
+PixelBuffer PixelBuffer::wrap(uint32_t* external, int w, int h, int rowStride) {
+    return PixelBuffer(external, w, h, rowStride);
 }
 
-PixelBuffer::Color PixelBuffer::Color::operator*(float scalar) const {
-    return Color(r * scalar, g * scalar, b * scalar, a * scalar);
+// Copies always own their pixels, even of a wrapped buffer
+PixelBuffer::PixelBuffer(const PixelBuffer& other) : width(other.width), height(other.height), stride(other.width) {
+    storage.resize((size_t)width * height);
+    pixels = storage.data();
+    for (int y = 0; y < height; y++) {
+        std::memcpy(row(y), other.pixels + (size_t)y * other.stride, width * sizeof(uint32_t));
+    }
 }
 
-// PixelBuffer implementations
-PixelBuffer::PixelBuffer(int w, int h) : width(w), height(h) {
-    pixels.resize(w * h);
+PixelBuffer& PixelBuffer::operator=(const PixelBuffer& other) {
+    if (this != &other) {
+        *this = PixelBuffer(other);
+    }
+    return *this;
 }
 
 void PixelBuffer::clear(uint32_t color) {
-    std::fill(pixels.begin(), pixels.end(), color);
+    for (int y = 0; y < height; y++) {
+        std::fill(row(y), row(y) + width, color);
+    }
 }
 
 void PixelBuffer::setPixel(int x, int y, uint32_t color) {
     if (x >= 0 && x < width && y >= 0 && y < height) {
-        pixels[y * width + x] = color;
+        pixels[(size_t)y * stride + x] = color;
     }
 }
 
 uint32_t PixelBuffer::getPixel(int x, int y) const {
     if (x >= 0 && x < width && y >= 0 && y < height) {
-        return pixels[y * width + x];
+        return pixels[(size_t)y * stride + x];
     }
     return 0;
 }
 
-const uint32_t* PixelBuffer::getData() const { return pixels.data(); }
+const uint32_t* PixelBuffer::getData() const { return pixels; }
+PixelSpan PixelBuffer::getSpan() { return { pixels, width, height, stride }; }
 int PixelBuffer::getWidth() const { return width; }
 int PixelBuffer::getHeight() const { return height; }
+int PixelBuffer::getStride() const { return stride; }
+bool PixelBuffer::isWrapped() const { return pixels != storage.data(); }
+PixelBuffer::ClipRect PixelBuffer::getBounds() const { return { 0, 0, width - 1, height - 1 }; }
 
 void PixelBuffer::drawLine(int x0, int y0, int x1, int y1, uint32_t color) {
     // Bresenham's line algorithm
@@ -87,94 +93,176 @@ void PixelBuffer::drawTriangle(int x0, int y0, int x1, int y1, int x2, int y2, u
     drawLine(x2, y2, x0, y0, color);
 }
 
-void PixelBuffer::fillTriangle(int x0, int y0, int x1, int y1, int x2, int y2, uint32_t color) {
-    // Sort vertices by Y coordinate (top to bottom)
-    if (y0 > y1) { std::swap(x0, x1); std::swap(y0, y1); }
-    if (y0 > y2) { std::swap(x0, x2); std::swap(y0, y2); }
-    if (y1 > y2) { std::swap(x1, x2); std::swap(y1, y2); }
-
-    // Handle degenerate cases (flat triangles or lines)
-    if (y0 == y2) return; // All points on same horizontal line
-
-    // Calculate slopes for triangle edges
-    auto drawScanline = [&](int y, int x_start, int x_end) {
-        if (x_start > x_end) std::swap(x_start, x_end);
-        for (int x = x_start; x <= x_end; x++) {
-            setPixel(x, y, color);
+// Half-space triangle rasterizer
+//
+// Each edge is an integer function E(x, y) = a*x + b*y + c that is >= 0 on the
+// inner side. The bounding box is walked in 8x8 tiles aligned to the screen:
+// tiles fully outside one edge are rejected, tiles fully inside all three edges
+// are filled row by row without any per-pixel test, and only tiles straddling
+// an edge step the edge functions pixel by pixel. 64-bit math keeps projected
+// vertices far off screen from overflowing.
+namespace {
+    struct EdgeFunction {
+        int64_t a, b, c;
+        
+        EdgeFunction(int xa, int ya, int xb, int yb)
+            : a((int64_t)ya - yb), b((int64_t)xb - xa),
+              c((int64_t)xa * yb - (int64_t)xb * ya) {}
+        
+        int64_t at(int x, int y) const { return a * x + b * y + c; }
+    };
+    
+    // Locates the covered run of a partial tile row; a convex triangle covers
+    // at most one contiguous run per row. Returns the run length (0 if empty).
+    int findCoveredRun(const int64_t edges[3], const int64_t steps[3], int count, int& runStart) {
+        int64_t e0 = edges[0], e1 = edges[1], e2 = edges[2];
+        runStart = -1;
+        for (int i = 0; i < count; i++) {
+            if ((e0 | e1 | e2) >= 0) {
+                if (runStart < 0) runStart = i;
+            } else if (runStart >= 0) {
+                return i - runStart;
+            }
+            e0 += steps[0]; e1 += steps[1]; e2 += steps[2];
+        }
+        return runStart < 0 ? 0 : count - runStart;
+    }
+    
+    struct FlatShader {
+        uint32_t color;
+        
+        void span(uint32_t* row, int x, int count, int) const {
+            std::fill_n(row + x, count, color);
+        }
+        
+        void partial(uint32_t* row, int x, int count, int y, const int64_t edges[3], const int64_t steps[3]) const {
+            int runStart;
+            int runLength = findCoveredRun(edges, steps, count, runStart);
+            if (runLength > 0) span(row, x + runStart, runLength, y);
         }
     };
-
-    // Fill the triangle using scanline algorithm
-    for (int y = y0; y <= y2; y++) {
-        // Calculate intersection points with triangle edges
-        float x_left, x_right;
+    
+    // Interpolates vertex colors through the vectorized span kernels
+    struct GradientShader {
+        struct ChannelPlane { double base, dx, dy; };
+        ChannelPlane planes[4];
+        GradientRowKernel kernel;
+        
+        GradientRow rowAt(int x, int y) const {
+            GradientRow r = {};
+            for (int ch = 0; ch < 4; ch++) {
+                r.color[ch] = (float)(planes[ch].base + planes[ch].dx * x + planes[ch].dy * y);
+                r.colorStep[ch] = (float)planes[ch].dx;
+            }
+            return r;
+        }
         
-        // Left edge: always from top (x0,y0) to bottom (x2,y2)
-        if (y2 != y0) {
-            x_left = x0 + (float)(x2 - x0) * (y - y0) / (y2 - y0);
-        } else {
-            x_left = x0;
+        void span(uint32_t* row, int x, int count, int y) const {
+            kernel(row + x, count, rowAt(x, y));
         }
         
-        // Right edge: depends on whether we're in upper or lower part
-        if (y <= y1) {
-            // Upper part: from (x0,y0) to (x1,y1)
-            if (y1 != y0) {
-                x_right = x0 + (float)(x1 - x0) * (y - y0) / (y1 - y0);
-            } else {
-                x_right = x0;
+        void partial(uint32_t* row, int x, int count, int y, const int64_t edges[3], const int64_t steps[3]) const {
+            // The kernels test edges in 32-bit lanes (and may evaluate up to a
+            // vector width past the end); huge off-screen triangles that do not
+            // fit resolve their run here and take the unconditional path.
+            const int64_t limit = INT32_MAX;
+            bool fits = true;
+            for (int k = 0; k < 3; k++) {
+                int64_t reach = std::abs(steps[k]) * (count + 8);
+                fits = fits && std::abs(edges[k]) + reach < limit;
+            }
+            if (!fits) {
+                int runStart;
+                int runLength = findCoveredRun(edges, steps, count, runStart);
+                if (runLength > 0) span(row, x + runStart, runLength, y);
+                return;
             }
-        } else {
-            // Lower part: from (x1,y1) to (x2,y2)
-            if (y2 != y1) {
-                x_right = x1 + (float)(x2 - x1) * (y - y1) / (y2 - y1);
-            } else {
-                x_right = x1;
+            
+            GradientRow r = rowAt(x, y);
+            for (int k = 0; k < 3; k++) {
+                r.edge[k] = (int32_t)edges[k];
+                r.edgeStep[k] = (int32_t)steps[k];
             }
+            kernel(row + x, count, r);
         }
-        
-        drawScanline(y, (int)x_left, (int)x_right);
-    }
+    };
 }
 
-void PixelBuffer::fillTriangleBarycentric(int x0, int y0, int x1, int y1, int x2, int y2, uint32_t color) {
-    // Calculate bounding box
-    int min_x = std::min({x0, x1, x2});
-    int max_x = std::max({x0, x1, x2});
-    int min_y = std::min({y0, y1, y2});
-    int max_y = std::max({y0, y1, y2});
-
-    // Clamp to screen bounds
-    min_x = std::max(0, min_x);
-    max_x = std::min(width - 1, max_x);
-    min_y = std::max(0, min_y);
-    max_y = std::min(height - 1, max_y);
-
-    // Helper function to calculate barycentric coordinates
-    auto sign = [](int x0, int y0, int x1, int y1, int x2, int y2) -> float {
-        return (x0 - x2) * (y1 - y2) - (x1 - x2) * (y0 - y2);
+template <typename Shader>
+void PixelBuffer::rasterizeTriangle(int x0, int y0, int x1, int y1, int x2, int y2, const ClipRect& clip, Shader& shader) {
+    // Calculate bounding box, clamped to the clip rect (itself inside the screen)
+    int min_x = std::max({0, clip.minX, std::min({x0, x1, x2})});
+    int max_x = std::min({width - 1, clip.maxX, std::max({x0, x1, x2})});
+    int min_y = std::max({0, clip.minY, std::min({y0, y1, y2})});
+    int max_y = std::min({height - 1, clip.maxY, std::max({y0, y1, y2})});
+    if (min_x > max_x || min_y > max_y) return;
+
+    // Edge i is opposite vertex i, so E0 + E1 + E2 is twice the signed area
+    EdgeFunction edges[3] = {
+        EdgeFunction(x1, y1, x2, y2),
+        EdgeFunction(x2, y2, x0, y0),
+        EdgeFunction(x0, y0, x1, y1)
     };
+    int64_t area = edges[0].at(x0, y0);
+    if (area == 0) return; // Degenerate triangle
+    if (area < 0) {
+        // Flip clockwise triangles so "inside" is always E >= 0
+        for (auto& e : edges) { e.a = -e.a; e.b = -e.b; e.c = -e.c; }
+    }
+
+    int tileMinX = min_x & ~(kTileSize - 1);
+    int tileMinY = min_y & ~(kTileSize - 1);
 
-    // Calculate triangle area (used for barycentric coordinates)
-    float area = sign(x0, y0, x1, y1, x2, y2);
-    if (std::abs(area) < 0.001f) return; // Degenerate triangle
-
-    // For each pixel in bounding box
-    for (int y = min_y; y <= max_y; y++) {
-        for (int x = min_x; x <= max_x; x++) {
-            // Calculate barycentric coordinates
-            float w0 = sign(x, y, x1, y1, x2, y2) / area;
-            float w1 = sign(x0, y0, x, y, x2, y2) / area;
-            float w2 = sign(x0, y0, x1, y1, x, y) / area;
-
-            // Check if point is inside triangle
-            if (w0 >= 0 && w1 >= 0 && w2 >= 0) {
-                setPixel(x, y, color);
+    for (int ty = tileMinY; ty <= max_y; ty += kTileSize) {
+        int y_start = std::max(ty, min_y);
+        int y_end = std::min(ty + kTileSize - 1, max_y);
+        
+        for (int tx = tileMinX; tx <= max_x; tx += kTileSize) {
+            int x_start = std::max(tx, min_x);
+            int x_end = std::min(tx + kTileSize - 1, max_x);
+            int spanW = x_end - x_start;
+            int spanH = y_end - y_start;
+            
+            // Classify the tile against each edge using its extreme corners
+            bool rejected = false;
+            bool accepted = true;
+            for (const auto& e : edges) {
+                int64_t origin = e.at(x_start, y_start);
+                int64_t lo = origin + std::min<int64_t>(0, e.a * spanW) + std::min<int64_t>(0, e.b * spanH);
+                int64_t hi = origin + std::max<int64_t>(0, e.a * spanW) + std::max<int64_t>(0, e.b * spanH);
+                if (hi < 0) { rejected = true; break; }
+                if (lo < 0) accepted = false;
+            }
+            if (rejected) continue;
+            
+            if (accepted) {
+                for (int y = y_start; y <= y_end; y++) {
+                    shader.span(row(y), x_start, spanW + 1, y);
+                }
+                continue;
+            }
+            
+            // Partial tile: let the shader resolve coverage row by row
+            const int64_t steps[3] = { edges[0].a, edges[1].a, edges[2].a };
+            for (int y = y_start; y <= y_end; y++) {
+                const int64_t rowEdges[3] = {
+                    edges[0].at(x_start, y), edges[1].at(x_start, y), edges[2].at(x_start, y)
+                };
+                shader.partial(row(y), x_start, spanW + 1, y, rowEdges, steps);
             }
         }
     }
 }
 
+void PixelBuffer::fillTriangle(int x0, int y0, int x1, int y1, int x2, int y2, uint32_t color) {
+    FlatShader shader = { color };
+    rasterizeTriangle(x0, y0, x1, y1, x2, y2, getBounds(), shader);
+}
+
+void PixelBuffer::fillTriangleBarycentric(int x0, int y0, int x1, int y1, int x2, int y2, uint32_t color) {
+    fillTriangle(x0, y0, x1, y1, x2, y2, color);
+}
+
 void PixelBuffer::drawTriangleWireframe(int x0, int y0, int x1, int y1, int x2, int y2, 
                               uint32_t wireframe_color, uint32_t fill_color, bool filled) {
     if (filled) {
@@ -187,144 +275,62 @@ void PixelBuffer::drawTriangleWireframe(int x0, int y0, int x1, int y1, int x2,
 }
 
 void PixelBuffer::fillRectangle(int x, int y, int w, int h, uint32_t color) {
-    for (int py = y; py < y + h; py++) {
-        for (int px = x; px < x + w; px++) {
-            setPixel(px, py, color);
-        }
+    // Clip once, then fill whole rows
+    int x_start = std::max(0, x);
+    int x_end = std::min(width, x + w);
+    int y_start = std::max(0, y);
+    int y_end = std::min(height, y + h);
+    if (x_start >= x_end) return;
+    
+    for (int py = y_start; py < y_end; py++) {
+        std::fill(row(py) + x_start, row(py) + x_end, color);
     }
 }
 
 void PixelBuffer::fillTriangleGradient(int x0, int y0, uint32_t color0,
                          int x1, int y1, uint32_t color1,
                          int x2, int y2, uint32_t color2) {
-    // Calculate bounding box
-    int min_x = std::min({x0, x1, x2});
-    int max_x = std::max({x0, x1, x2});
-    int min_y = std::min({y0, y1, y2});
-    int max_y = std::max({y0, y1, y2});
-
-    // Clamp to screen bounds
-    min_x = std::max(0, min_x);
-    max_x = std::min(width - 1, max_x);
-    min_y = std::max(0, min_y);
-    max_y = std::min(height - 1, max_y);
-
-    // Convert colors to floating point for interpolation
-    Color c0(color0), c1(color1), c2(color2);
-
-    // Helper function to calculate barycentric coordinates
-    auto sign = [](int x0, int y0, int x1, int y1, int x2, int y2) -> float {
-        return (x0 - x2) * (y1 - y2) - (x1 - x2) * (y0 - y2);
-    };
+    fillTriangleGradient(x0, y0, color0, x1, y1, color1, x2, y2, color2, getBounds());
+}
 
-    // Calculate triangle area (used for barycentric coordinates)
-    float area = sign(x0, y0, x1, y1, x2, y2);
-    if (std::abs(area) < 0.001f) return; // Degenerate triangle
-
-    // For each pixel in bounding box
-    for (int y = min_y; y <= max_y; y++) {
-        for (int x = min_x; x <= max_x; x++) {
-            // Calculate barycentric coordinates
-            float w0 = sign(x, y, x1, y1, x2, y2) / area;
-            float w1 = sign(x0, y0, x, y, x2, y2) / area;
-            float w2 = sign(x0, y0, x1, y1, x, y) / area;
-
-            // Check if point is inside triangle
-            if (w0 >= 0 && w1 >= 0 && w2 >= 0) {
-                // Interpolate color using barycentric coordinates
-                Color interpolatedColor = c0 * w0 + c1 * w1 + c2 * w2;
-                setPixel(x, y, interpolatedColor.toARGB());
-            }
+void PixelBuffer::fillTriangleGradient(int x0, int y0, uint32_t color0,
+                         int x1, int y1, uint32_t color1,
+                         int x2, int y2, uint32_t color2, const ClipRect& clip) {
+    // Barycentric weights are E_i / area, so every channel is a plane
+    // c(x, y) = base + dx * x + dy * y. Solve the planes once per triangle.
+    EdgeFunction edges[3] = {
+        EdgeFunction(x1, y1, x2, y2),
+        EdgeFunction(x2, y2, x0, y0),
+        EdgeFunction(x0, y0, x1, y1)
+    };
+    int64_t area = edges[0].at(x0, y0);
+    if (area == 0) return; // Degenerate triangle
+    double invArea = 1.0 / (double)area;
+
+    GradientShader shader;
+    shader.kernel = rasterKernels().gradientRow;
+    const uint32_t colors[3] = { color0, color1, color2 };
+    for (int ch = 0; ch < 4; ch++) {
+        int shift = 24 - ch * 8; // a, r, g, b
+        double base = 0, dx = 0, dy = 0;
+        for (int v = 0; v < 3; v++) {
+            double value = (colors[v] >> shift) & 0xFF;
+            base += value * edges[v].c;
+            dx += value * edges[v].a;
+            dy += value * edges[v].b;
         }
+        shader.planes[ch] = { base * invArea, dx * invArea, dy * invArea };
     }
+
+    rasterizeTriangle(x0, y0, x1, y1, x2, y2, clip, shader);
 }
 
 void PixelBuffer::fillTriangleGradientScanline(int x0, int y0, uint32_t color0,
                                  int x1, int y1, uint32_t color1,
                                  int x2, int y2, uint32_t color2) {
-    // Sort vertices by Y coordinate, keeping colors aligned
-    if (y0 > y1) { 
-        std::swap(x0, x1); std::swap(y0, y1); std::swap(color0, color1);
-    }
-    if (y0 > y2) { 
-        std::swap(x0, x2); std::swap(y0, y2); std::swap(color0, color2);
-    }
-    if (y1 > y2) { 
-        std::swap(x1, x2); std::swap(y1, y2); std::swap(color1, color2);
-    }
-
-    if (y0 == y2) return; // Degenerate triangle
-
-    Color c0(color0), c1(color1), c2(color2);
-
-    // Helper to interpolate between two points (position and color)
-    auto lerp = [](float a, float b, float t) -> float {
-        return a + t * (b - a);
-    };
-
-    auto lerpColor = [&](const Color& ca, const Color& cb, float t) -> Color {
-        return Color(
-            lerp(ca.r, cb.r, t),
-            lerp(ca.g, cb.g, t), 
-            lerp(ca.b, cb.b, t),
-            lerp(ca.a, cb.a, t)
-        );
-    };
-
-    // Fill the triangle using scanline algorithm with color interpolation
-    for (int y = y0; y <= y2; y++) {
-        float t_main = (float)(y - y0) / (y2 - y0);
-        
-        // Left edge: always from top to bottom
-        float x_left = lerp(x0, x2, t_main);
-        Color color_left = lerpColor(c0, c2, t_main);
-        
-        // Right edge: depends on whether we're in upper or lower part
-        float x_right;
-        Color color_right;
-        
-        if (y <= y1) {
-            // Upper part: from (x0,y0) to (x1,y1)
-            if (y1 != y0) {
-                float t_upper = (float)(y - y0) / (y1 - y0);
-                x_right = lerp(x0, x1, t_upper);
-                color_right = lerpColor(c0, c1, t_upper);
-            } else {
-                x_right = x0;
-                color_right = c0;
-            }
-        } else {
-            // Lower part: from (x1,y1) to (x2,y2)
-            if (y2 != y1) {
-                float t_lower = (float)(y - y1) / (y2 - y1);
-                x_right = lerp(x1, x2, t_lower);
-                color_right = lerpColor(c1, c2, t_lower);
-            } else {
-                x_right = x1;
-                color_right = c1;
-            }
-        }
-        
-        // Ensure left is actually left
-        if (x_left > x_right) {
-            std::swap(x_left, x_right);
-            std::swap(color_left, color_right);
-        }
-        
-        // Draw horizontal line with color interpolation
-        int x_start = (int)x_left;
-        int x_end = (int)x_right;
-        
-        for (int x = x_start; x <= x_end; x++) {
-            if (x_end != x_start) {
-                float t_horizontal = (float)(x - x_start) / (x_end - x_start);
-                Color finalColor = lerpColor(color_left, color_right, t_horizontal);
-                setPixel(x, y, finalColor.toARGB());
-            } else {
-                setPixel(x, y, color_left.toARGB());
-            }
-        }
-    }
+    // Kept for API compatibility; the tiled rasterizer interpolates the same
+    // vertex colors without the per-scanline edge divides
+    fillTriangleGradient(x0, y0, color0, x1, y1, color1, x2, y2, color2);
 }
 
 void PixelBuffer::fillTriangleRainbow(int x0, int y0, int x1, int y1, int x2, int y2) {
@@ -343,33 +349,46 @@ std::pair<int, int> PixelBuffer::project3DTo2D(const Vec3& point, int screenWidt
 }
 
 void PixelBuffer::render3DTriangle(const Triangle3D& triangle, int screenWidth, int screenHeight) {
+    drawScreenTriangle(setupTriangle(triangle, screenWidth, screenHeight), getBounds());
+}
+
+PixelBuffer::ScreenTriangle PixelBuffer::setupTriangle(const Triangle3D& triangle, int screenWidth, int screenHeight) {
+    ScreenTriangle screen;
+    
     // Project 3D vertices to 2D screen coordinates
-    auto p0 = project3DTo2D(triangle.vertices[0], screenWidth, screenHeight);
-    auto p1 = project3DTo2D(triangle.vertices[1], screenWidth, screenHeight);
-    auto p2 = project3DTo2D(triangle.vertices[2], screenWidth, screenHeight);
+    for (int i = 0; i < 3; i++) {
+        auto p = project3DTo2D(triangle.vertices[i], screenWidth, screenHeight);
+        screen.x[i] = p.first;
+        screen.y[i] = p.second;
+    }
     
     // Calculate lighting based on triangle normal (simple directional light)
-    Vec3 lightDir = Vec3(0.3f, -0.5f, -0.7f).normalize();
-    Vec3 normal = triangle.getNormal();
-    float lightIntensity = std::max(0.2f, -normal.dot(lightDir)); // Clamp to avoid pure black
-    
-    // Apply lighting to colors
-    auto applyLighting = [lightIntensity](uint32_t color) -> uint32_t {
-        uint8_t a = (color >> 24) & 0xFF;
-        uint8_t r = (uint8_t)(((color >> 16) & 0xFF) * lightIntensity);
-        uint8_t g = (uint8_t)(((color >> 8) & 0xFF) * lightIntensity);
-        uint8_t b = (uint8_t)((color & 0xFF) * lightIntensity);
-        return (a << 24) | (r << 16) | (g << 8) | b;
-    };
-    
-    uint32_t litColor0 = applyLighting(triangle.colors[0]);
-    uint32_t litColor1 = applyLighting(triangle.colors[1]);
-    uint32_t litColor2 = applyLighting(triangle.colors[2]);
-    
+    float intensity = lightIntensity(triangle.getNormal());
+    for (int i = 0; i < 3; i++) {
+        screen.colors[i] = applyLighting(triangle.colors[i], intensity);
+    }
+    return screen;
+}
+
+float PixelBuffer::lightIntensity(const Vec3& normal) {
+    static const Vec3 lightDir = Vec3(0.3f, -0.5f, -0.7f).normalize();
+    return std::max(0.2f, -normal.dot(lightDir)); // Clamp to avoid pure black
+}
+
+uint32_t PixelBuffer::applyLighting(uint32_t color, float intensity) {
+    uint8_t a = (color >> 24) & 0xFF;
+    uint8_t r = (uint8_t)(((color >> 16) & 0xFF) * intensity);
+    uint8_t g = (uint8_t)(((color >> 8) & 0xFF) * intensity);
+    uint8_t b = (uint8_t)((color & 0xFF) * intensity);
+    return (a << 24) | (r << 16) | (g << 8) | b;
+}
+
+void PixelBuffer::drawScreenTriangle(const ScreenTriangle& triangle, const ClipRect& clip) {
     // Render the triangle with gradient colors
     fillTriangleGradient(
-        p0.first, p0.second, litColor0,
-        p1.first, p1.second, litColor1,
-        p2.first, p2.second, litColor2
+        triangle.x[0], triangle.y[0], triangle.colors[0],
+        triangle.x[1], triangle.y[1], triangle.colors[1],
+        triangle.x[2], triangle.y[2], triangle.colors[2],
+        clip
     );
-}
\ No newline at end of file
+}
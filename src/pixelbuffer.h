@@ -4,33 +4,77 @@
 #include <cstdint>
 #include "utils.h"
 
+// Non-owning view of 32-bit ARGB pixels: a PixelBuffer's rows or a locked
+// texture. stride is the distance between rows in pixels (pitch / 4).
+struct PixelSpan {
+    uint32_t* pixels;
+    int width, height;
+    int stride;
+    
+    uint32_t* row(int y) const { return pixels + (size_t)y * stride; }
+};
+
 class PixelBuffer {
+public:
+    // Inclusive pixel rectangle that fills are restricted to
+    struct ClipRect {
+        int minX, minY, maxX, maxY;
+    };
+    
+    // Projected and lit triangle, ready to be rasterized into any clip rect
+    struct ScreenTriangle {
+        int x[3], y[3];
+        uint32_t colors[3];
+    };
+
 private:
-    std::vector<uint32_t> pixels;
+    std::vector<uint32_t> storage;   // empty when wrapping external memory
+    uint32_t* pixels;
     int width, height;
+    int stride;                      // pixels from one row to the next
     
-    // Color utility functions for vertex color interpolation
-    struct Color {
-        float r, g, b, a;
-        
-        Color(uint32_t argb = 0xFF000000);
-        Color(float red, float green, float blue, float alpha = 1.0f);
-        
-        uint32_t toARGB() const;
-        Color operator+(const Color& other) const;
-        Color operator*(float scalar) const;
-    };
+    // Tiled half-space rasterizer shared by every triangle fill path.
+    // Coverage is resolved per 8x8 tile. Rows of fully covered tiles go to
+    // shader.span(row, x, count, y); rows of tiles crossing an edge go to
+    // shader.partial(row, x, count, y, edges, edgeSteps) with the 64-bit edge
+    // values at the first pixel, so the shader can run its own edge tests.
+    static constexpr int kTileSize = 8;
+    
+    template <typename Shader>
+    void rasterizeTriangle(int x0, int y0, int x1, int y1, int x2, int y2, const ClipRect& clip, Shader& shader);
+    void fillTriangleGradient(int x0, int y0, uint32_t color0,
+                             int x1, int y1, uint32_t color1,
+                             int x2, int y2, uint32_t color2, const ClipRect& clip);
+    
+    uint32_t* row(int y) { return pixels + (size_t)y * stride; }
+    
+    PixelBuffer(uint32_t* external, int w, int h, int rowStride);
 
 public:
     PixelBuffer(int w, int h);
     
+    // A buffer that draws into memory it does not own, such as a locked
+    // streaming texture (rowStride = pitch / 4). The memory must outlive it.
+    static PixelBuffer wrap(uint32_t* external, int w, int h, int rowStride);
+    
+    PixelBuffer(const PixelBuffer& other);
+    PixelBuffer& operator=(const PixelBuffer& other);
+    PixelBuffer(PixelBuffer&&) = default;
+    PixelBuffer& operator=(PixelBuffer&&) = default;
+    
     void clear(uint32_t color = 0xFF000000);
     void setPixel(int x, int y, uint32_t color);
     uint32_t getPixel(int x, int y) const;
     
+    // First row; rows are getStride() pixels apart, which for an owning
+    // buffer is always the width
     const uint32_t* getData() const;
+    PixelSpan getSpan();
     int getWidth() const;
     int getHeight() const;
+    int getStride() const;
+    bool isWrapped() const;
+    ClipRect getBounds() const;
     
     // Basic drawing functions
     void drawLine(int x0, int y0, int x1, int y1, uint32_t color);
@@ -51,6 +95,16 @@ public:
     void fillTriangleRainbow(int x0, int y0, int x1, int y1, int x2, int y2);
     
     // 3D rendering functions
-    std::pair<int, int> project3DTo2D(const Vec3& point, int screenWidth, int screenHeight);
+    static std::pair<int, int> project3DTo2D(const Vec3& point, int screenWidth, int screenHeight);
     void render3DTriangle(const Triangle3D& triangle, int screenWidth, int screenHeight);
+    
+    // Split form of render3DTriangle: setup projects and lights once, then the
+    // triangle can be drawn into disjoint clip rects from different threads
+    static ScreenTriangle setupTriangle(const Triangle3D& triangle, int screenWidth, int screenHeight);
+    void drawScreenTriangle(const ScreenTriangle& triangle, const ClipRect& clip);
+    
+    // The directional light setupTriangle applies: intensity for a unit face
+    // normal, and a color scaled by it
+    static float lightIntensity(const Vec3& normal);
+    static uint32_t applyLighting(uint32_t color, float intensity);
 };
\ No newline at end of file
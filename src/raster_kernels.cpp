@@ -0,0 +1,137 @@
+#include "raster_kernels.h"
+#include <algorithm>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define RASTER_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+void gradientRowScalar(uint32_t* dst, int count, const GradientRow& row) {
+    int32_t e0 = row.edge[0], e1 = row.edge[1], e2 = row.edge[2];
+    for (int i = 0; i < count; i++) {
+        if ((e0 | e1 | e2) >= 0) {
+            uint32_t packed = 0;
+            for (int ch = 0; ch < 4; ch++) {
+                float value = row.color[ch] + row.colorStep[ch] * i;
+                value = std::max(0.0f, std::min(255.0f, value));
+                packed |= (uint32_t)value << (24 - ch * 8);
+            }
+            dst[i] = packed;
+        }
+        e0 += row.edgeStep[0]; e1 += row.edgeStep[1]; e2 += row.edgeStep[2];
+    }
+}
+
+#ifdef RASTER_KERNELS_X86
+
+__attribute__((target("sse4.1")))
+void gradientRowSSE41(uint32_t* dst, int count, const GradientRow& row) {
+    const __m128i lane = _mm_setr_epi32(0, 1, 2, 3);
+    const __m128 laneF = _mm_cvtepi32_ps(lane);
+    const __m128 lo = _mm_setzero_ps();
+    const __m128 hi = _mm_set1_ps(255.0f);
+
+    __m128i e[3], eStep[3];
+    for (int k = 0; k < 3; k++) {
+        __m128i step = _mm_set1_epi32(row.edgeStep[k]);
+        e[k] = _mm_add_epi32(_mm_set1_epi32(row.edge[k]), _mm_mullo_epi32(lane, step));
+        eStep[k] = _mm_slli_epi32(step, 2);
+    }
+    __m128 c[4], cStep[4];
+    for (int ch = 0; ch < 4; ch++) {
+        __m128 step = _mm_set1_ps(row.colorStep[ch]);
+        c[ch] = _mm_add_ps(_mm_set1_ps(row.color[ch]), _mm_mul_ps(laneF, step));
+        cStep[ch] = _mm_mul_ps(step, _mm_set1_ps(4.0f));
+    }
+
+    for (int i = 0; i < count; i += 4) {
+        // Sign bit of e0 | e1 | e2 is set for pixels outside any edge
+        __m128i outside = _mm_srai_epi32(_mm_or_si128(_mm_or_si128(e[0], e[1]), e[2]), 31);
+        __m128i tail = _mm_cmpgt_epi32(_mm_set1_epi32(count - i), lane);
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_andnot_si128(outside, tail)));
+
+        if (mask) {
+            __m128i packed = _mm_setzero_si128();
+            for (int ch = 0; ch < 4; ch++) {
+                __m128i value = _mm_cvttps_epi32(_mm_min_ps(hi, _mm_max_ps(lo, c[ch])));
+                packed = _mm_or_si128(packed, _mm_slli_epi32(value, 24 - ch * 8));
+            }
+            if (mask == 0xF) {
+                _mm_storeu_si128((__m128i*)(dst + i), packed);
+            } else {
+                alignas(16) uint32_t lanes[4];
+                _mm_store_si128((__m128i*)lanes, packed);
+                for (int l = 0; l < 4; l++) {
+                    if (mask & (1 << l)) dst[i + l] = lanes[l];
+                }
+            }
+        }
+
+        for (int k = 0; k < 3; k++) e[k] = _mm_add_epi32(e[k], eStep[k]);
+        for (int ch = 0; ch < 4; ch++) c[ch] = _mm_add_ps(c[ch], cStep[ch]);
+    }
+}
+
+__attribute__((target("avx2")))
+void gradientRowAVX2(uint32_t* dst, int count, const GradientRow& row) {
+    const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256 laneF = _mm256_cvtepi32_ps(lane);
+    const __m256 lo = _mm256_setzero_ps();
+    const __m256 hi = _mm256_set1_ps(255.0f);
+
+    __m256i e[3], eStep[3];
+    for (int k = 0; k < 3; k++) {
+        __m256i step = _mm256_set1_epi32(row.edgeStep[k]);
+        e[k] = _mm256_add_epi32(_mm256_set1_epi32(row.edge[k]), _mm256_mullo_epi32(lane, step));
+        eStep[k] = _mm256_slli_epi32(step, 3);
+    }
+    __m256 c[4], cStep[4];
+    for (int ch = 0; ch < 4; ch++) {
+        __m256 step = _mm256_set1_ps(row.colorStep[ch]);
+        c[ch] = _mm256_add_ps(_mm256_set1_ps(row.color[ch]), _mm256_mul_ps(laneF, step));
+        cStep[ch] = _mm256_mul_ps(step, _mm256_set1_ps(8.0f));
+    }
+
+    for (int i = 0; i < count; i += 8) {
+        __m256i outside = _mm256_srai_epi32(_mm256_or_si256(_mm256_or_si256(e[0], e[1]), e[2]), 31);
+        __m256i tail = _mm256_cmpgt_epi32(_mm256_set1_epi32(count - i), lane);
+        __m256i mask = _mm256_andnot_si256(outside, tail);
+
+        if (!_mm256_testz_si256(mask, mask)) {
+            __m256i packed = _mm256_setzero_si256();
+            for (int ch = 0; ch < 4; ch++) {
+                __m256i value = _mm256_cvttps_epi32(_mm256_min_ps(hi, _mm256_max_ps(lo, c[ch])));
+                packed = _mm256_or_si256(packed, _mm256_slli_epi32(value, 24 - ch * 8));
+            }
+            // Masked-off lanes are never touched, so the tail cannot fault
+            _mm256_maskstore_epi32((int*)(dst + i), mask, packed);
+        }
+
+        for (int k = 0; k < 3; k++) e[k] = _mm256_add_epi32(e[k], eStep[k]);
+        for (int ch = 0; ch < 4; ch++) c[ch] = _mm256_add_ps(c[ch], cStep[ch]);
+    }
+}
+
+#endif // RASTER_KERNELS_X86
+
+RasterKernels selectRasterKernels() {
+#ifdef RASTER_KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return { "AVX2", 8, gradientRowAVX2 };
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return { "SSE4.1", 4, gradientRowSSE41 };
+    }
+#endif
+    return { "Scalar", 1, gradientRowScalar };
+}
+
+} // namespace
+
+const RasterKernels& rasterKernels() {
+    static const RasterKernels kernels = selectRasterKernels();
+    return kernels;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+
+// One row segment of a gradient-filled triangle, in the layout consumed by the
+// span kernels. Edge values are relative to the first pixel of the segment and
+// step by edgeStep per pixel; a pixel is written when all three are >= 0.
+// Passing zero edges and steps writes the whole segment unconditionally.
+struct GradientRow {
+    int32_t edge[3];
+    int32_t edgeStep[3];
+    float color[4];      // a, r, g, b at the first pixel (0..255)
+    float colorStep[4];  // per-pixel increment for each channel
+};
+
+using GradientRowKernel = void (*)(uint32_t* dst, int count, const GradientRow& row);
+
+// Span kernels selected once per process from the host CPU features
+struct RasterKernels {
+    const char* name;
+    int lanes;
+    GradientRowKernel gradientRow;
+};
+
+const RasterKernels& rasterKernels();
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Header-only random number generators with explicit state. Every engine
+// derives its distributions from RandomDistributions, so all of them offer the
+// same API: next(), nextFloat(min, max), nextInt(min, max) and batch fills.
+
+// SplitMix64 finalizer: a strong 64-bit bit mixer
+inline uint64_t mixBits64(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+template <typename Engine>
+class RandomDistributions {
+public:
+    // Uniform float in [min, max) from the top 24 bits of a draw
+    float nextFloat(float min, float max) {
+        float unit = (float)(engine().next() >> 40) * (1.0f / 16777216.0f);
+        return min + (max - min) * unit;
+    }
+
+    // Uniform int in [min, max] (inclusive, like std::uniform_int_distribution),
+    // using Lemire's multiply-shift with rejection so there is no modulo bias
+    int nextInt(int min, int max) {
+        uint64_t range = (uint64_t)((int64_t)max - (int64_t)min) + 1;
+        uint64_t product = (engine().next() >> 32) * range;
+        uint32_t low = (uint32_t)product;
+        if (low < range) {
+            uint32_t threshold = (uint32_t)((0x100000000ULL - range) % range);
+            while (low < threshold) {
+                product = (engine().next() >> 32) * range;
+                low = (uint32_t)product;
+            }
+        }
+        return (int)((int64_t)min + (int64_t)(product >> 32));
+    }
+
+    // Batch forms: fill out[0..count) exactly as repeated single calls would
+    void fillFloats(float* out, size_t count, float min, float max) {
+        const float scale = (max - min) * (1.0f / 16777216.0f);
+        for (size_t i = 0; i < count; i++) {
+            out[i] = min + (float)(engine().next() >> 40) * scale;
+        }
+    }
+
+    void fillInts(int* out, size_t count, int min, int max) {
+        for (size_t i = 0; i < count; i++) {
+            out[i] = nextInt(min, max);
+        }
+    }
+
+private:
+    Engine& engine() { return static_cast<Engine&>(*this); }
+};
+
+// xoshiro256** (Blackman & Vigna): fast, 256-bit state, passes BigCrush.
+// Also a UniformRandomBitGenerator, so it works with <random> if needed.
+class Xoshiro256 : public RandomDistributions<Xoshiro256> {
+public:
+    using result_type = uint64_t;
+
+    explicit Xoshiro256(uint64_t seedValue = 0x853C49E6748FEA9BULL) { seed(seedValue); }
+
+    // Expands a 64-bit seed into the full state with SplitMix64
+    void seed(uint64_t seedValue) {
+        for (auto& word : state) {
+            seedValue += 0x9E3779B97F4A7C15ULL;
+            word = mixBits64(seedValue);
+        }
+    }
+
+    uint64_t next() {
+        const uint64_t result = rotl(state[1] * 5, 7) * 9;
+        const uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    uint64_t operator()() { return next(); }
+    static constexpr uint64_t min() { return 0; }
+    static constexpr uint64_t max() { return UINT64_MAX; }
+
+private:
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    uint64_t state[4];
+};
+
+// Counter-based generator: output n of a stream is mixBits64(key + n * golden),
+// so any stream can be created in O(1) from a few integers (seed, frame, band)
+// and its values do not depend on which thread draws them or when.
+class CounterRng : public RandomDistributions<CounterRng> {
+public:
+    CounterRng(uint64_t seed, uint64_t streamA = 0, uint64_t streamB = 0)
+        : key(mixBits64(seed ^ mixBits64(streamA ^ mixBits64(streamB + 0x9E3779B97F4A7C15ULL)))), counter(0) {}
+
+    uint64_t next() {
+        return mixBits64(key + (++counter) * 0x9E3779B97F4A7C15ULL);
+    }
+
+private:
+    uint64_t key;
+    uint64_t counter;
+};
@@ -0,0 +1,133 @@
+#include "scene.h"
+#include <algorithm>
+#include <cmath>
+
+Scene::Scene(int width, int height) : fractalSystem(width, height), weirdChaosMode(true), lastTriangleCount(0) {
+    // Set global pointer for injection functions
+    g_fractalSystem = &fractalSystem;
+}
+
+Scene::~Scene() {
+    if (g_fractalSystem == &fractalSystem) {
+        g_fractalSystem = nullptr;
+    }
+}
+
+void Scene::renderFrame(PixelBuffer& target, float deltaTime) {
+    if (weirdChaosMode) {
+        renderWeirdChaos(target, deltaTime);
+    } else {
+        renderFractal(target.getSpan(), deltaTime);
+    }
+}
+
+void Scene::renderWeirdChaos(PixelBuffer& target, float deltaTime) {
+    int width = target.getWidth();
+    int height = target.getHeight();
+    
+    // Clear with a randomly shifting dark background
+    uint32_t bgColor = 0xFF000000 | 
+                      (randomInt(5, 25) << 16) | 
+                      (randomInt(5, 25) << 8) | 
+                      randomInt(5, 25);
+    target.clear(bgColor);
+    
+    // Update weird visual entities
+    weirdVisualManager.update(deltaTime);
+    
+    // Set up perspective projection matrix with current aspect ratio
+    float fov = 45.0f * M_PI / 180.0f; // 45 degrees in radians
+    float aspect = (float)width / height;
+    Matrix4x4 projection = Matrix4x4::perspective(fov, aspect, 0.1f, 100.0f);
+    
+    // Render weird visual entities first (background layer)
+    MeshSpan weirdMesh = weirdVisualManager.getMesh();
+    lastTriangleCount = weirdMesh.triangleCount;
+    
+    // Transform each shared vertex once; the renderer culls the triangles
+    // facing away and projects and bins the rest by vertex index
+    transformedVertices.resize(weirdMesh.vertexCount);
+    for (size_t i = 0; i < weirdMesh.vertexCount; i++) {
+        transformedVertices[i] = projection.transform(weirdMesh.vertices[i]);
+    }
+    
+    binnedRenderer.begin(width, height);
+    binnedRenderer.submitMesh(transformedVertices.data(), weirdMesh.vertexCount,
+                              weirdMesh.triangles, weirdMesh.triangleCount);
+    
+    // Rasterize the binned triangles on all render threads
+    binnedRenderer.flush(target);
+    
+    // Add some chaos background effects (scale with resolution)
+    if (randomFloat(0, 1) < 0.1f) { // 10% chance per frame
+        // Random streaks across screen
+        int numStreaks = randomInt(1, 5);
+        for (int i = 0; i < numStreaks; i++) {
+            target.drawLine(
+                randomInt(0, width), randomInt(0, height),
+                randomInt(0, width), randomInt(0, height),
+                randomColor()
+            );
+        }
+    }
+    
+    // Occasionally add screen-wide effects (scale with resolution)
+    if (randomFloat(0, 1) < 0.05f) { // 5% chance per frame
+        switch (randomInt(0, 2)) {
+            case 0: // Random dots
+                for (int i = 0; i < randomInt(50, 200); i++) {
+                    target.setPixel(randomInt(0, width), randomInt(0, height), randomColor());
+                }
+                break;
+            case 1: // Random rectangles
+                for (int i = 0; i < randomInt(3, 8); i++) {
+                    int maxSize = std::min(width, height) / 20; // Scale with resolution
+                    int x = randomInt(0, width - maxSize);
+                    int y = randomInt(0, height - maxSize);
+                    target.fillRectangle(x, y, randomInt(10, maxSize), randomInt(10, maxSize), randomColor());
+                }
+                break;
+        }
+    }
+}
+
+void Scene::renderFractal(const PixelSpan& target, float deltaTime) {
+    // The color pass writes every pixel, so there is nothing to clear
+    fractalSystem.update(deltaTime);
+    fractalSystem.render(target);
+}
+
+void Scene::resize(int width, int height) {
+    // Resize fractal system to match new resolution
+    fractalSystem.resize(width, height);
+}
+
+void Scene::toggleMode() {
+    weirdChaosMode = !weirdChaosMode;
+}
+
+bool Scene::isWeirdChaosMode() const {
+    return weirdChaosMode;
+}
+
+void Scene::resetWeirdEntities() {
+    int populationScale = weirdVisualManager.getPopulationScale();
+    weirdVisualManager = WeirdVisualManager();
+    weirdVisualManager.setPopulationScale(populationScale);
+}
+
+FractalGameOfLifeSystem& Scene::getFractalSystem() {
+    return fractalSystem;
+}
+
+WeirdVisualManager& Scene::getWeirdVisualManager() {
+    return weirdVisualManager;
+}
+
+const WeirdVisualManager& Scene::getWeirdVisualManager() const {
+    return weirdVisualManager;
+}
+
+size_t Scene::getLastTriangleCount() const {
+    return lastTriangleCount;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "pixelbuffer.h"
+#include "weird_entities.h"
+#include "fractal_system.h"
+#include "binned_renderer.h"
+
+// Per-frame scene logic shared by the interactive (SDL) and headless front
+// ends: owns both visual systems and renders the active mode into a
+// PixelBuffer. Registers its fractal system as g_fractalSystem.
+class Scene {
+public:
+    Scene(int width, int height);
+    ~Scene();
+    
+    Scene(const Scene&) = delete;
+    Scene& operator=(const Scene&) = delete;
+    
+    // Advances the active mode by deltaTime and draws it into target, which
+    // may wrap a locked texture (PixelBuffer::wrap). Every pixel is written.
+    void renderFrame(PixelBuffer& target, float deltaTime);
+    
+    void resize(int width, int height);
+    void toggleMode();
+    bool isWeirdChaosMode() const;
+    void resetWeirdEntities();
+    
+    FractalGameOfLifeSystem& getFractalSystem();
+    WeirdVisualManager& getWeirdVisualManager();
+    const WeirdVisualManager& getWeirdVisualManager() const;
+    size_t getLastTriangleCount() const;
+    
+private:
+    void renderWeirdChaos(PixelBuffer& target, float deltaTime);
+    void renderFractal(const PixelSpan& target, float deltaTime);
+    
+    WeirdVisualManager weirdVisualManager;
+    FractalGameOfLifeSystem fractalSystem;
+    BinnedRenderer binnedRenderer;
+    std::vector<Vec3> transformedVertices;   // this frame's entity vertices after projection
+    bool weirdChaosMode;
+    size_t lastTriangleCount;
+};
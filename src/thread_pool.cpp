@@ -0,0 +1,123 @@
+#include "thread_pool.h"
+#include <algorithm>
+
+namespace {
+    constexpr size_t kNoWorker = (size_t)-1;
+    
+    // Worker index of the parallelFor work this thread is executing, or
+    // kNoWorker. Nested calls run inline under the same index, so per-worker
+    // scratch picked by the outer body is never shared with another thread.
+    thread_local size_t currentWorker = kNoWorker;
+}
+
+ThreadPool::ThreadPool(size_t workerCount) : stopping(false), generation(0), workersDone(0),
+    body(nullptr), count(0), nextIndex(0) {
+    if (workerCount == 0) {
+        workerCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (size_t worker = 1; worker < workerCount; worker++) {
+        threads.emplace_back(&ThreadPool::workerLoop, this, worker);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+size_t ThreadPool::getWorkerCount() const {
+    return threads.size() + 1;
+}
+
+void ThreadPool::parallelFor(size_t indexCount, const Body& indexBody) {
+    if (indexCount == 0) return;
+    if (currentWorker != kNoWorker) {
+        for (size_t i = 0; i < indexCount; i++) {
+            indexBody(i, currentWorker);
+        }
+        return;
+    }
+    if (threads.empty() || indexCount == 1) {
+        currentWorker = 0;
+        for (size_t i = 0; i < indexCount; i++) {
+            indexBody(i, 0);
+        }
+        currentWorker = kNoWorker;
+        return;
+    }
+
+    std::lock_guard<std::mutex> submitLock(submitMutex);
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        body = &indexBody;
+        count = indexCount;
+        nextIndex.store(0, std::memory_order_relaxed);
+        workersDone = 0;
+        generation++;
+    }
+    wake.notify_all();
+
+    runIndices(0);
+
+    // Every worker checks in once it finds no more indices, so none of them
+    // can still be touching this job when it is replaced
+    std::unique_lock<std::mutex> lock(stateMutex);
+    finished.wait(lock, [this] { return workersDone == threads.size(); });
+    body = nullptr;
+}
+
+void ThreadPool::runIndices(size_t worker) {
+    currentWorker = worker;
+    size_t index;
+    while ((index = nextIndex.fetch_add(1, std::memory_order_relaxed)) < count) {
+        (*body)(index, worker);
+    }
+    currentWorker = kNoWorker;
+}
+
+void ThreadPool::workerLoop(size_t worker) {
+    size_t seenGeneration = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(stateMutex);
+            wake.wait(lock, [&] { return stopping || generation != seenGeneration; });
+            if (stopping) return;
+            seenGeneration = generation;
+        }
+
+        runIndices(worker);
+
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            workersDone++;
+        }
+        finished.notify_one();
+    }
+}
+
+namespace {
+    std::unique_ptr<ThreadPool>& globalPoolSlot() {
+        static std::unique_ptr<ThreadPool> pool;
+        return pool;
+    }
+}
+
+ThreadPool& globalThreadPool() {
+    auto& pool = globalPoolSlot();
+    if (!pool) {
+        pool = std::make_unique<ThreadPool>();
+    }
+    return *pool;
+}
+
+void configureGlobalThreadPool(size_t workerCount) {
+    auto& pool = globalPoolSlot();
+    pool.reset();
+    pool = std::make_unique<ThreadPool>(workerCount);
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size pool of worker threads for data-parallel frame work.
+// The calling thread takes part in every parallelFor as worker 0, so a pool
+// created with one thread simply runs everything inline.
+class ThreadPool {
+public:
+    // Runs body(index, worker) for each index; worker is in [0, getWorkerCount())
+    using Body = std::function<void(size_t index, size_t worker)>;
+
+    explicit ThreadPool(size_t workerCount = 0); // 0 = one worker per hardware thread
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t getWorkerCount() const;
+
+    // Blocks until body has run for every index in [0, count). Indices are
+    // handed out dynamically, so cost does not need to be uniform. Nested
+    // calls from inside a body run inline on the calling worker and pass
+    // that worker's index, so per-worker scratch stays private.
+    void parallelFor(size_t count, const Body& body);
+
+private:
+    void workerLoop(size_t worker);
+    void runIndices(size_t worker);
+
+    std::vector<std::thread> threads;
+    std::mutex submitMutex;   // one parallelFor at a time
+    std::mutex stateMutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    bool stopping;
+    size_t generation;
+    size_t workersDone;
+
+    const Body* body;
+    size_t count;
+    std::atomic<size_t> nextIndex;
+};
+
+// Process-wide pool shared by the renderer and simulation. It is created on
+// first use with one worker per hardware thread unless a size was configured
+// first; reconfiguring replaces the pool and must not race with its use.
+ThreadPool& globalThreadPool();
+void configureGlobalThreadPool(size_t workerCount);
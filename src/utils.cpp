@@ -1,53 +1,26 @@
 #include "utils.h"
+#include "hsv_color.h"
 #include <cstdint>
+#include <random>
 
 // Random number generator setup
-std::random_device rd;
-std::mt19937 rng(rd());
-
-// Helper function to get random float in range
-float randomFloat(float min, float max) {
-    std::uniform_real_distribution<float> dist(min, max);
-    return dist(rng);
+namespace {
+    uint64_t hardwareSeed() {
+        std::random_device rd;
+        return ((uint64_t)rd() << 32) ^ rd();
+    }
 }
 
-// Helper function to get random int in range
-int randomInt(int min, int max) {
-    std::uniform_int_distribution<int> dist(min, max);
-    return dist(rng);
-}
+Xoshiro256 rng(hardwareSeed());
 
 // Helper function to get random color
 uint32_t randomColor() {
     return 0xFF000000 | (randomInt(0, 255) << 16) | (randomInt(0, 255) << 8) | randomInt(0, 255);
 }
 
-// HSV to RGB color conversion
+// HSV to RGB color conversion; hue in degrees, wrapped (see hsv_color.h)
 uint32_t hsvToRgb(float h, float s, float v) {
-    float c = v * s;
-    float x = c * (1 - abs(fmod(h / 60.0f, 2) - 1));
-    float m = v - c;
-    
-    float r, g, b;
-    if (h >= 0 && h < 60) {
-        r = c; g = x; b = 0;
-    } else if (h >= 60 && h < 120) {
-        r = x; g = c; b = 0;
-    } else if (h >= 120 && h < 180) {
-        r = 0; g = c; b = x;
-    } else if (h >= 180 && h < 240) {
-        r = 0; g = x; b = c;
-    } else if (h >= 240 && h < 300) {
-        r = x; g = 0; b = c;
-    } else {
-        r = c; g = 0; b = x;
-    }
-    
-    uint8_t ri = (uint8_t)((r + m) * 255);
-    uint8_t gi = (uint8_t)((g + m) * 255);
-    uint8_t bi = (uint8_t)((b + m) * 255);
-    
-    return 0xFF000000 | (ri << 16) | (gi << 8) | bi;
+    return hsvToArgb(h, s, v);
 }
 
 uint32_t createRainbowColor(float t) {
@@ -62,8 +35,7 @@ uint32_t createRainbowColor(float t) {
 }
 
 uint32_t createNeonColor(float intensity, float hueShift) {
-    float hue = fmod(intensity * 360.0f + hueShift, 360.0f);
-    return hsvToRgb(hue, 1.0f, std::min(1.0f, intensity * 1.5f));
+    return hsvToArgb(intensity * 360.0f + hueShift, 1.0f, intensity * 1.5f);
 }
 
 uint32_t blendColors(uint32_t color1, uint32_t color2, float t) {
@@ -212,8 +184,12 @@ Triangle3D::Triangle3D(Vec3 v0, Vec3 v1, Vec3 v2, uint32_t c0, uint32_t c1, uint
 }
 
 Vec3 Triangle3D::getNormal() const {
-    Vec3 edge1 = vertices[1] - vertices[0];
-    Vec3 edge2 = vertices[2] - vertices[0];
+    return faceNormal(vertices[0], vertices[1], vertices[2]);
+}
+
+Vec3 faceNormal(const Vec3& v0, const Vec3& v1, const Vec3& v2) {
+    Vec3 edge1 = v1 - v0;
+    Vec3 edge2 = v2 - v0;
     return edge1.cross(edge2).normalize();
 }
 
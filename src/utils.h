@@ -1,16 +1,17 @@
 #pragma once
 
 #include <cmath>
-#include <random>
+#include <cstdint>
 #include <algorithm>
+#include "rng.h"
 
-// Random number generator setup
-extern std::random_device rd;
-extern std::mt19937 rng;
+// Global random number generator for everything that is not a parallel
+// stream (see rng.h); seeded from std::random_device at startup
+extern Xoshiro256 rng;
 
-// Helper functions
-float randomFloat(float min, float max);
-int randomInt(int min, int max);
+// Helper functions - thin inline wrappers over the global generator
+inline float randomFloat(float min, float max) { return rng.nextFloat(min, max); }
+inline int randomInt(int min, int max) { return rng.nextInt(min, max); }
 uint32_t randomColor();
 
 // Color utility functions
@@ -60,4 +61,16 @@ struct Triangle3D {
     
     Vec3 getNormal() const;
     Triangle3D transform(const Matrix4x4& matrix) const;
+};
+
+// Unit normal of the triangle v0 v1 v2, zero when it is degenerate. Both
+// triangle paths cull and light with it.
+Vec3 faceNormal(const Vec3& v0, const Vec3& v1, const Vec3& v2);
+
+// Triangle of an indexed mesh: three indices into the mesh's vertex array.
+// Colors stay per corner, since triangles sharing a vertex may color it
+// differently.
+struct IndexedTriangle {
+    uint32_t vertices[3];
+    uint32_t colors[3];
 };
\ No newline at end of file
@@ -1,7 +1,8 @@
 #include "weird_entities.h"
 #include <cmath>
 #include <algorithm>
-#include <tuple>
+#include "fast_math.h"
+#include "thread_pool.h"
 
 WeirdEntity::WeirdEntity(Vec3 pos) : position(pos), morphTime(0.0f) {
     velocity = Vec3(randomFloat(-2, 2), randomFloat(-2, 2), randomFloat(-1, 1));
@@ -13,311 +14,561 @@ WeirdEntity::WeirdEntity(Vec3 pos) : position(pos), morphTime(0.0f) {
     type = randomInt(0, 6); // Different entity types
     
     // Generate weird color palette
-    int numColors = randomInt(3, 6);
-    for (int i = 0; i < numColors; i++) {
-        colors.push_back(randomColor());
+    colors.count = randomInt(3, EntityPalette::kCapacity);
+    for (int i = 0; i < colors.count; i++) {
+        colors.entries[i] = randomColor();
     }
 }
 
-void WeirdEntity::update(float deltaTime, int screenWidth, int screenHeight) {
-    life -= deltaTime;
-    morphTime += deltaTime;
+// Template meshes. Every entity type is a fixed mesh whose vertices move. The topology
+// (which vertices make each triangle, which palette entry colors each
+// corner) and the fixed angles of every vertex are built once per type.
+// A frame only evaluates a few sin/cos of the entity's rotation and morph
+// clock and combines them with the template angles through the angle
+// addition formulas, instead of calling trig for every vertex.
+
+namespace {
+    // cos and sin of an angle. Adding two phases adds their angles.
+    struct Phase {
+        float c, s;
+        
+        static Phase of(double angle) { return { (float)std::cos(angle), (float)std::sin(angle) }; }
+        static Phase fast(float angle) {
+            Phase phase;
+            fastSincos(angle, phase.s, phase.c);
+            return phase;
+        }
+        
+        Phase operator+(const Phase& other) const {
+            return { c * other.c - s * other.s, s * other.c + c * other.s };
+        }
+    };
     
-    // Update position with some chaos
-    position.x += velocity.x * deltaTime;
-    position.y += velocity.y * deltaTime;
-    position.z += velocity.z * deltaTime;
+    constexpr int kMaxColorIndex = 32;   // corner color indices stay below this
+    constexpr int kMinSpikes = 4, kMaxSpikes = 12;
     
-    // Weird physics - entities can bounce, wrap, or teleport
-    if (randomFloat(0, 1) < 0.01f) { // 1% chance per frame for chaos
-        switch (randomInt(0, 3)) {
-            case 0: // Bounce
-                velocity.x *= -1.2f;
-                velocity.y *= -1.2f;
-                break;
-            case 1: // Random teleport
-                position.x = randomFloat(-3, 3);
-                position.y = randomFloat(-2, 2);
-                break;
-            case 2: // Speed up
-                velocity = velocity * randomFloat(1.5f, 2.0f);
-                break;
-            case 3: // Change direction
-                velocity = Vec3(randomFloat(-3, 3), randomFloat(-3, 3), randomFloat(-1, 1));
-                break;
+    struct TemplateTriangle {
+        uint8_t vertex[3];
+        uint8_t color[3];   // palette index, taken modulo the palette size
+    };
+    
+    struct MeshTopology {
+        int vertexCount = 0;
+        std::vector<TemplateTriangle> triangles;
+        
+        void add(int v0, int v1, int v2, int c0, int c1, int c2) {
+            triangles.push_back({{(uint8_t)v0, (uint8_t)v1, (uint8_t)v2}, {(uint8_t)c0, (uint8_t)c1, (uint8_t)c2}});
         }
-    }
+    };
     
-    // Wrap around screen
-    if (position.x > 4) position.x = -4;
-    if (position.x < -4) position.x = 4;
-    if (position.y > 3) position.y = -3;
-    if (position.y < -3) position.y = 3;
+    // Spiky star with n spikes: inner, tip and inner-end vertex per spike
+    struct SpikyTemplate {
+        MeshTopology topology;
+        std::vector<Phase> inner, tip, innerEnd;   // spike angle, + 0.1, + 0.2
+        std::vector<Phase> index;                  // angle i, for the per-spike wobble
+    };
     
-    // Update rotation
-    rotation += rotationSpeed * deltaTime;
+    // Blob: center, 12 ring vertices, 12 raised vertices
+    struct BlobTemplate {
+        static constexpr int kSegments = 12;
+        MeshTopology topology;
+        Phase ring[kSegments], ringTriple[kSegments], index[kSegments];
+    };
     
-    // Morphing size
-    float morphFactor = sin(morphTime * randomFloat(1, 3)) * 0.3f + 1.0f;
-    size = size * morphFactor;
-}
-
-bool WeirdEntity::isDead() const {
-    return life <= 0;
-}
-
-std::vector<Triangle3D> WeirdEntity::generateTriangles() const {
-    std::vector<Triangle3D> triangles;
-    float lifeFactor = life / maxLife;
+    // Fractal spikes: a triangle per node of a three-level ternary tree,
+    // nodes in the order the old recursion emitted them (parents first)
+    struct FractalTemplate {
+        struct Node {
+            int parent;   // -1 for the entity position
+            int level;
+            Phase direction, side;   // node angle and + 2.1
+            Phase lift;              // angle level, for the morph lift
+        };
+        MeshTopology topology;
+        std::vector<Node> nodes;
+    };
+    
+    // Ribbon: the +width and -width vertex of 20 points along the path
+    struct RibbonTemplate {
+        static constexpr int kPoints = 20;
+        MeshTopology topology;
+        float t[kPoints];
+        Phase loop[kPoints], wave[kPoints], twist[kPoints];   // angles 4 pi t, 2 pi t, 6 t
+    };
+    
+    // Orb: 6 rings of a center plus 8 vertices
+    struct OrbTemplate {
+        static constexpr int kRings = 6, kSegments = 8;
+        MeshTopology topology;
+        float height[kRings], radius[kRings];   // in units of size.z and size.x
+        Phase index[kRings], segment[kSegments];
+    };
     
-    switch (type) {
-        case 0: // Spiky Star
-            generateSpikyTriangles(triangles, lifeFactor);
-            break;
-        case 1: // Morphing Blob
-            generateBlobTriangles(triangles, lifeFactor);
-            break;
-        case 2: // Fractal Spikes
-            generateFractalTriangles(triangles, lifeFactor);
-            break;
-        case 3: // Twisted Ribbon
-            generateRibbonTriangles(triangles, lifeFactor);
-            break;
-        case 4: // Pulsing Orb
-            generateOrbTriangles(triangles, lifeFactor);
-            break;
-        case 5: // Chaotic Fragments
-            generateFragmentTriangles(triangles, lifeFactor);
-            break;
-        default: // Weird Polyhedron
-            generatePolyhedronTriangles(triangles, lifeFactor);
-            break;
+    // Fragments: 15 loose triangles
+    struct FragmentTemplate {
+        static constexpr int kFragments = 15;
+        MeshTopology topology;
+        Phase index[kFragments];
+        Phase corner[kFragments][3];   // angles 0.8 i, + 2.1, + 4.2
+    };
+    
+    // Polyhedron: 8 vertices and a fixed face list
+    struct PolyhedronTemplate {
+        static constexpr int kVertices = 8;
+        MeshTopology topology;
+        Phase corner[kVertices], index[kVertices];
+    };
+    
+    void buildFractalNodes(FractalTemplate& mesh, int parent, int level, int maxLevel) {
+        if (level >= maxLevel) return;
+        for (int i = 0; i < 3; i++) {
+            double angle = (i / 3.0f) * 2 * M_PI + level * 0.7f;
+            int node = (int)mesh.nodes.size();
+            mesh.nodes.push_back({parent, level, Phase::of(angle), Phase::of(angle + 2.1f), Phase::of(level)});
+            mesh.topology.add(node * 3, node * 3 + 1, node * 3 + 2, level + i, level + i, level + i);
+            buildFractalNodes(mesh, node, level + 1, maxLevel);
+        }
+        mesh.topology.vertexCount = (int)mesh.nodes.size() * 3;
     }
     
-    return triangles;
-}
-
-void WeirdEntity::generateSpikyTriangles(std::vector<Triangle3D>& triangles, float lifeFactor) const {
-    int spikes = 8 + (int)(sin(morphTime) * 4);
-    for (int i = 0; i < spikes; i++) {
-        float angle = (i / (float)spikes) * 2 * M_PI + rotation;
-        float innerRadius = size.x * 0.3f;
-        float outerRadius = size.x * (1.0f + sin(morphTime * 2 + i) * 0.5f);
-        
-        Vec3 center = position;
-        Vec3 inner1 = center + Vec3(cos(angle) * innerRadius, sin(angle) * innerRadius, 0);
-        Vec3 outer = center + Vec3(cos(angle + 0.1f) * outerRadius, sin(angle + 0.1f) * outerRadius, sin(morphTime + i) * 0.2f);
-        Vec3 inner2 = center + Vec3(cos(angle + 0.2f) * innerRadius, sin(angle + 0.2f) * innerRadius, 0);
+    struct EntityTemplates {
+        SpikyTemplate spiky[kMaxSpikes - kMinSpikes + 1];
+        BlobTemplate blob;
+        FractalTemplate fractal;
+        RibbonTemplate ribbon;
+        OrbTemplate orb;
+        FragmentTemplate fragments;
+        PolyhedronTemplate polyhedron;
         
-        uint32_t color1 = colors[i % colors.size()];
-        uint32_t color2 = colors[(i + 1) % colors.size()];
-        uint32_t color3 = colors[(i + 2) % colors.size()];
-        
-        triangles.push_back(Triangle3D(inner1, outer, inner2, color1, color2, color3));
+        EntityTemplates() {
+            for (int spikes = kMinSpikes; spikes <= kMaxSpikes; spikes++) {
+                SpikyTemplate& mesh = spiky[spikes - kMinSpikes];
+                for (int i = 0; i < spikes; i++) {
+                    double angle = (i / (float)spikes) * 2 * M_PI;
+                    mesh.inner.push_back(Phase::of(angle));
+                    mesh.tip.push_back(Phase::of(angle + 0.1f));
+                    mesh.innerEnd.push_back(Phase::of(angle + 0.2f));
+                    mesh.index.push_back(Phase::of(i));
+                    mesh.topology.add(i * 3, i * 3 + 1, i * 3 + 2, i, i + 1, i + 2);
+                }
+                mesh.topology.vertexCount = spikes * 3;
+            }
+            
+            // The last segment ends on the first ring vertex
+            for (int i = 0; i < BlobTemplate::kSegments; i++) {
+                double angle = (i / (float)BlobTemplate::kSegments) * 2 * M_PI;
+                blob.ring[i] = Phase::of(angle);
+                blob.ringTriple[i] = Phase::of(angle * 3);
+                blob.index[i] = Phase::of(i);
+                int ring1 = 1 + i, ring2 = 1 + (i + 1) % BlobTemplate::kSegments;
+                int raised = 1 + BlobTemplate::kSegments + i;
+                blob.topology.add(0, ring1, ring2, i, i + 1, i + 2);
+                blob.topology.add(ring1, ring2, raised, i, i + 1, i + 2);
+            }
+            blob.topology.vertexCount = 1 + 2 * BlobTemplate::kSegments;
+            
+            buildFractalNodes(fractal, -1, 0, 3);
+            
+            for (int k = 0; k < RibbonTemplate::kPoints; k++) {
+                float t = k / (float)RibbonTemplate::kPoints;
+                ribbon.t[k] = t;
+                ribbon.loop[k] = Phase::of(t * 4 * M_PI);
+                ribbon.wave[k] = Phase::of(t * 2 * M_PI);
+                ribbon.twist[k] = Phase::of(t * 6);
+            }
+            // Vertex 2k is point k + width, 2k + 1 is point k - width
+            for (int i = 0; i < RibbonTemplate::kPoints - 1; i++) {
+                ribbon.topology.add(2 * i, 2 * i + 1, 2 * i + 2, i, i + 1, i + 2);
+                ribbon.topology.add(2 * i + 1, 2 * i + 3, 2 * i + 2, i, i + 1, i + 2);
+            }
+            ribbon.topology.vertexCount = 2 * RibbonTemplate::kPoints;
+            
+            // A ring's radius follows the sphere at its height, so it only
+            // depends on the ring; vertex r * 9 is the ring center
+            for (int ring = 0; ring < OrbTemplate::kRings; ring++) {
+                float height = (ring / (float)OrbTemplate::kRings - 0.5f) * 2;
+                orb.height[ring] = height;
+                orb.radius[ring] = std::sqrt(std::max(0.0f, 1.0f - height * height));
+                orb.index[ring] = Phase::of(ring);
+                for (int seg = 0; seg < OrbTemplate::kSegments; seg++) {
+                    int base = ring * (OrbTemplate::kSegments + 1);
+                    orb.topology.add(base, base + 1 + seg, base + 1 + (seg + 1) % OrbTemplate::kSegments,
+                                     ring, ring + seg, ring + seg + 1);
+                }
+            }
+            for (int seg = 0; seg < OrbTemplate::kSegments; seg++) {
+                orb.segment[seg] = Phase::of((seg / (float)OrbTemplate::kSegments) * 2 * M_PI);
+            }
+            orb.topology.vertexCount = OrbTemplate::kRings * (OrbTemplate::kSegments + 1);
+            
+            for (int i = 0; i < FragmentTemplate::kFragments; i++) {
+                fragments.index[i] = Phase::of(i);
+                fragments.corner[i][0] = Phase::of(i * 0.8f);
+                fragments.corner[i][1] = Phase::of(i * 0.8f + 2.1f);
+                fragments.corner[i][2] = Phase::of(i * 0.8f + 4.2f);
+                fragments.topology.add(i * 3, i * 3 + 1, i * 3 + 2, i, i + 1, i + 2);
+            }
+            fragments.topology.vertexCount = FragmentTemplate::kFragments * 3;
+            
+            // Connect vertices in weird ways
+            static const int faces[12][3] = {
+                {0, 1, 2}, {2, 3, 4}, {4, 5, 6}, {6, 7, 0},
+                {0, 2, 4}, {4, 6, 0}, {1, 3, 5}, {5, 7, 1},
+                {0, 1, 7}, {1, 2, 3}, {3, 4, 5}, {5, 6, 7}
+            };
+            for (int i = 0; i < PolyhedronTemplate::kVertices; i++) {
+                polyhedron.corner[i] = Phase::of((i / 8.0f) * 2 * M_PI);
+                polyhedron.index[i] = Phase::of(i);
+            }
+            for (const auto& face : faces) {
+                polyhedron.topology.add(face[0], face[1], face[2], face[0], face[1], face[2]);
+            }
+            polyhedron.topology.vertexCount = PolyhedronTemplate::kVertices;
+        }
+    };
+    
+    const EntityTemplates& entityTemplates() {
+        static const EntityTemplates templates;
+        return templates;
+    }
+    
+    // Planar offset of length radius along phase, at height z
+    inline Vec3 polar(const Phase& phase, float radius, float z = 0) {
+        return Vec3(phase.c * radius, phase.s * radius, z);
+    }
+    
+    const SpikyTemplate& spikyTemplate(const WeirdEntity& entity) {
+        int spikes = 8 + (int)(std::sin(entity.morphTime) * 4);
+        spikes = std::max(kMinSpikes, std::min(kMaxSpikes, spikes));
+        return entityTemplates().spiky[spikes - kMinSpikes];
+    }
+    
+    const MeshTopology& topologyOf(const WeirdEntity& entity) {
+        const EntityTemplates& templates = entityTemplates();
+        switch (entity.type) {
+            case 0: return spikyTemplate(entity).topology;
+            case 1: return templates.blob.topology;
+            case 2: return templates.fractal.topology;
+            case 3: return templates.ribbon.topology;
+            case 4: return templates.orb.topology;
+            case 5: return templates.fragments.topology;
+            default: return templates.polyhedron.topology;
+        }
     }
-}
 
-void WeirdEntity::generateBlobTriangles(std::vector<Triangle3D>& triangles, float lifeFactor) const {
-    int segments = 12;
-    for (int i = 0; i < segments; i++) {
-        float angle1 = (i / (float)segments) * 2 * M_PI;
-        float angle2 = ((i + 1) / (float)segments) * 2 * M_PI;
-        
-        float noise1 = sin(morphTime * 2 + angle1 * 3) * 0.3f + 1.0f;
-        float noise2 = sin(morphTime * 2 + angle2 * 3) * 0.3f + 1.0f;
-        
-        Vec3 center = position;
-        Vec3 p1 = center + Vec3(cos(angle1) * size.x * noise1, sin(angle1) * size.y * noise1, 0);
-        Vec3 p2 = center + Vec3(cos(angle2) * size.x * noise2, sin(angle2) * size.y * noise2, 0);
-        Vec3 p3 = center + Vec3(0, 0, size.z * sin(morphTime + i));
-        
-        uint32_t c1 = colors[i % colors.size()];
-        uint32_t c2 = colors[(i + 1) % colors.size()];
-        uint32_t c3 = colors[(i + 2) % colors.size()];
-        
-        triangles.push_back(Triangle3D(center, p1, p2, c1, c2, c3));
-        triangles.push_back(Triangle3D(p1, p2, p3, c1, c2, c3));
+    // This frame's position of every template vertex of the entity's type
+    void deformVertices(const WeirdEntity& entity, Vec3* vertices) {
+        const EntityTemplates& templates = entityTemplates();
+        const Vec3& position = entity.position;
+        const Vec3& size = entity.size;
+        float rotation = entity.rotation, morphTime = entity.morphTime;
+        Phase spin = Phase::fast(rotation);
+    
+        switch (entity.type) {
+            case 0: { // Spiky Star
+                const SpikyTemplate& mesh = spikyTemplate(entity);
+                Phase morph = Phase::fast(morphTime), pulse = Phase::fast(morphTime * 2);
+                float innerRadius = size.x * 0.3f;
+                for (size_t i = 0; i < mesh.index.size(); i++) {
+                    float outerRadius = size.x * (1.0f + (pulse + mesh.index[i]).s * 0.5f);
+                    vertices[i * 3] = position + polar(mesh.inner[i] + spin, innerRadius);
+                    vertices[i * 3 + 1] = position + polar(mesh.tip[i] + spin, outerRadius, (morph + mesh.index[i]).s * 0.2f);
+                    vertices[i * 3 + 2] = position + polar(mesh.innerEnd[i] + spin, innerRadius);
+                }
+                break;
+            }
+            case 1: { // Morphing Blob
+                const BlobTemplate& mesh = templates.blob;
+                Phase morph = Phase::fast(morphTime), pulse = Phase::fast(morphTime * 2);
+                vertices[0] = position;
+                for (int i = 0; i < BlobTemplate::kSegments; i++) {
+                    float noise = (pulse + mesh.ringTriple[i]).s * 0.3f + 1.0f;
+                    vertices[1 + i] = position + Vec3(mesh.ring[i].c * size.x * noise, mesh.ring[i].s * size.y * noise, 0);
+                    vertices[1 + BlobTemplate::kSegments + i] = position + Vec3(0, 0, size.z * (morph + mesh.index[i]).s);
+                }
+                break;
+            }
+            case 2: { // Fractal Spikes
+                const FractalTemplate& mesh = templates.fractal;
+                Phase offset = Phase::fast(rotation + morphTime);
+                Phase morph = Phase::fast(morphTime);
+                Vec3 centers[40];
+                for (size_t n = 0; n < mesh.nodes.size(); n++) {
+                    const FractalTemplate::Node& node = mesh.nodes[n];
+                    float scale = size.x;
+                    for (int level = 0; level < node.level; level++) scale *= 0.6f;
+                
+                    Phase angle = node.direction + offset;
+                    float lift = (morph + node.lift).s * scale * 0.3f;
+                    Vec3 center = (node.parent < 0 ? position : centers[node.parent]) + polar(angle, scale, lift);
+                    centers[n] = center;
+                
+                    vertices[n * 3] = center + polar(angle, scale * 0.3f);
+                    vertices[n * 3 + 1] = center + polar(node.side + offset, scale * 0.3f);
+                    vertices[n * 3 + 2] = center + Vec3(0, 0, scale * 0.5f);
+                }
+                break;
+            }
+            case 3: { // Twisted Ribbon
+                const RibbonTemplate& mesh = templates.ribbon;
+                Phase morph = Phase::fast(morphTime);
+                for (int k = 0; k < RibbonTemplate::kPoints; k++) {
+                    Vec3 point = position + Vec3(
+                        (mesh.loop[k] + morph).c * size.x,
+                        (mesh.wave[k] + morph).s * size.y,
+                        (mesh.t[k] - 0.5f) * size.z * 2
+                    );
+                    Phase twist = mesh.twist[k] + morph;
+                    Vec3 width = Vec3(twist.s * 0.1f, twist.c * 0.1f, 0);
+                    vertices[2 * k] = point + width;
+                    vertices[2 * k + 1] = point - width;
+                }
+                break;
+            }
+            case 4: { // Pulsing Orb
+                const OrbTemplate& mesh = templates.orb;
+                Phase pulse = Phase::fast(morphTime * 2);
+                Phase segments[OrbTemplate::kSegments];
+                for (int seg = 0; seg < OrbTemplate::kSegments; seg++) {
+                    segments[seg] = mesh.segment[seg] + spin;
+                }
+                for (int ring = 0; ring < OrbTemplate::kRings; ring++) {
+                    float ringHeight = mesh.height[ring] * size.z;
+                    float ringRadius = mesh.radius[ring] * size.x * (1.0f + (pulse + mesh.index[ring]).s * 0.3f);
+                    Vec3* ringVertices = vertices + ring * (OrbTemplate::kSegments + 1);
+                    ringVertices[0] = position + Vec3(0, 0, ringHeight);
+                    for (int seg = 0; seg < OrbTemplate::kSegments; seg++) {
+                        ringVertices[1 + seg] = position + polar(segments[seg], ringRadius, ringHeight);
+                    }
+                }
+                break;
+            }
+            case 5: { // Chaotic Fragments
+                const FragmentTemplate& mesh = templates.fragments;
+                Phase morph = Phase::fast(morphTime);
+                Phase drift = Phase::fast(morphTime * 1.3f), sway = Phase::fast(morphTime * 0.7f);
+                Phase turn = Phase::fast(rotation + morphTime);
+                for (int i = 0; i < FragmentTemplate::kFragments; i++) {
+                    Vec3 center = position + Vec3(
+                        (morph + mesh.index[i]).s * size.x * (1 + i * 0.1f),
+                        (drift + mesh.index[i]).c * size.y * (1 + i * 0.1f),
+                        (sway + mesh.index[i]).s * size.z
+                    );
+                    float fragSize = size.x * 0.2f * (1.0f - i * 0.05f);
+                    vertices[i * 3] = center + polar(mesh.corner[i][0] + turn, fragSize);
+                    vertices[i * 3 + 1] = center + polar(mesh.corner[i][1] + turn, fragSize);
+                    vertices[i * 3 + 2] = center + polar(mesh.corner[i][2] + turn, fragSize, fragSize);
+                }
+                break;
+            }
+            default: { // Weird Polyhedron
+                const PolyhedronTemplate& mesh = templates.polyhedron;
+                Phase swell = Phase::fast(morphTime * 3), stretch = Phase::fast(morphTime * 2);
+                for (int i = 0; i < PolyhedronTemplate::kVertices; i++) {
+                    float radius = size.x * (1.0f + (swell + mesh.index[i]).s * 0.4f);
+                    float height = (i % 2 == 0 ? size.z : -size.z) * (1.0f + (stretch + mesh.index[i]).c * 0.3f);
+                    vertices[i] = position + polar(mesh.corner[i] + spin, radius, height);
+                }
+                break;
+            }
+        }
     }
 }
 
-void WeirdEntity::generateFractalTriangles(std::vector<Triangle3D>& triangles, float lifeFactor) const {
-    generateFractalLevel(triangles, position, size.x, 0, 3);
+int WeirdEntity::getVertexCount() const {
+    return topologyOf(*this).vertexCount;
 }
 
-void WeirdEntity::generateFractalLevel(std::vector<Triangle3D>& triangles, Vec3 center, float scale, int level, int maxLevel) const {
-    if (level >= maxLevel) return;
-    
-    float angleOffset = rotation + level * 0.7f + morphTime;
-    for (int i = 0; i < 3; i++) {
-        float angle = (i / 3.0f) * 2 * M_PI + angleOffset;
-        Vec3 offset = Vec3(cos(angle) * scale, sin(angle) * scale, sin(morphTime + level) * scale * 0.3f);
-        Vec3 newCenter = center + offset;
-        
-        // Create triangle at this level
-        Vec3 p1 = newCenter + Vec3(cos(angle) * scale * 0.3f, sin(angle) * scale * 0.3f, 0);
-        Vec3 p2 = newCenter + Vec3(cos(angle + 2.1f) * scale * 0.3f, sin(angle + 2.1f) * scale * 0.3f, 0);
-        Vec3 p3 = newCenter + Vec3(0, 0, scale * 0.5f);
-        
-        uint32_t color = colors[(level + i) % colors.size()];
-        triangles.push_back(Triangle3D(p1, p2, p3, color, color, color));
-        
-        // Recurse
-        generateFractalLevel(triangles, newCenter, scale * 0.6f, level + 1, maxLevel);
-    }
+int WeirdEntity::getTriangleCount() const {
+    return (int)topologyOf(*this).triangles.size();
 }
 
-void WeirdEntity::generateRibbonTriangles(std::vector<Triangle3D>& triangles, float lifeFactor) const {
-    int segments = 20;
-    for (int i = 0; i < segments - 1; i++) {
-        float t1 = i / (float)segments;
-        float t2 = (i + 1) / (float)segments;
-        
-        // Create twisted ribbon path
-        Vec3 p1 = position + Vec3(
-            cos(t1 * 4 * M_PI + morphTime) * size.x,
-            sin(t1 * 2 * M_PI + morphTime) * size.y,
-            (t1 - 0.5f) * size.z * 2
-        );
-        Vec3 p2 = position + Vec3(
-            cos(t2 * 4 * M_PI + morphTime) * size.x,
-            sin(t2 * 2 * M_PI + morphTime) * size.y,
-            (t2 - 0.5f) * size.z * 2
-        );
-        
-        // Ribbon width
-        Vec3 width1 = Vec3(sin(t1 * 6 + morphTime) * 0.1f, cos(t1 * 6 + morphTime) * 0.1f, 0);
-        Vec3 width2 = Vec3(sin(t2 * 6 + morphTime) * 0.1f, cos(t2 * 6 + morphTime) * 0.1f, 0);
-        
-        triangles.push_back(Triangle3D(
-            p1 + width1, p1 - width1, p2 + width2,
-            colors[i % colors.size()], colors[(i+1) % colors.size()], colors[(i+2) % colors.size()]
-        ));
-        triangles.push_back(Triangle3D(
-            p1 - width1, p2 - width2, p2 + width2,
-            colors[i % colors.size()], colors[(i+1) % colors.size()], colors[(i+2) % colors.size()]
-        ));
+void WeirdEntity::generateMesh(Vec3* vertices, IndexedTriangle* triangles, uint32_t firstVertex) const {
+    deformVertices(*this, vertices);
+    
+    // Corner colors index the palette modulo its size; expand it once
+    uint32_t cornerColors[kMaxColorIndex];
+    for (int i = 0; i < kMaxColorIndex; i++) {
+        cornerColors[i] = colors[i % colors.size()];
     }
-}
-
-void WeirdEntity::generateOrbTriangles(std::vector<Triangle3D>& triangles, float lifeFactor) const {
-    int rings = 6;
-    int segments = 8;
     
-    for (int ring = 0; ring < rings; ring++) {
-        float ringHeight = (ring / (float)rings - 0.5f) * size.z * 2;
-        float ringRadius = sqrt(1.0f - pow(ringHeight / size.z, 2)) * size.x;
-        ringRadius *= (1.0f + sin(morphTime * 2 + ring) * 0.3f); // Pulsing
-        
-        for (int seg = 0; seg < segments; seg++) {
-            float angle1 = (seg / (float)segments) * 2 * M_PI + rotation;
-            float angle2 = ((seg + 1) / (float)segments) * 2 * M_PI + rotation;
-            
-            Vec3 p1 = position + Vec3(cos(angle1) * ringRadius, sin(angle1) * ringRadius, ringHeight);
-            Vec3 p2 = position + Vec3(cos(angle2) * ringRadius, sin(angle2) * ringRadius, ringHeight);
-            Vec3 center = position + Vec3(0, 0, ringHeight);
-            
-            triangles.push_back(Triangle3D(center, p1, p2, 
-                colors[ring % colors.size()], 
-                colors[(ring + seg) % colors.size()], 
-                colors[(ring + seg + 1) % colors.size()]));
+    for (const TemplateTriangle& t : topologyOf(*this).triangles) {
+        IndexedTriangle& triangle = *triangles++;
+        for (int k = 0; k < 3; k++) {
+            triangle.vertices[k] = firstVertex + t.vertex[k];
+            triangle.colors[k] = cornerColors[t.color[k]];
         }
     }
 }
 
-void WeirdEntity::generateFragmentTriangles(std::vector<Triangle3D>& triangles, float lifeFactor) const {
-    int fragments = 15;
-    for (int i = 0; i < fragments; i++) {
-        Vec3 offset = Vec3(
-            sin(morphTime + i) * size.x * (1 + i * 0.1f),
-            cos(morphTime * 1.3f + i) * size.y * (1 + i * 0.1f),
-            sin(morphTime * 0.7f + i) * size.z
-        );
-        
-        Vec3 center = position + offset;
-        float fragSize = size.x * 0.2f * (1.0f - i * 0.05f);
-        
-        // Random triangle orientation
-        float angle = rotation + i * 0.8f + morphTime;
-        Vec3 p1 = center + Vec3(cos(angle) * fragSize, sin(angle) * fragSize, 0);
-        Vec3 p2 = center + Vec3(cos(angle + 2.1f) * fragSize, sin(angle + 2.1f) * fragSize, 0);
-        Vec3 p3 = center + Vec3(cos(angle + 4.2f) * fragSize, sin(angle + 4.2f) * fragSize, fragSize);
-        
-        triangles.push_back(Triangle3D(p1, p2, p3, 
-            colors[i % colors.size()], 
-            colors[(i + 1) % colors.size()], 
-            colors[(i + 2) % colors.size()]));
-    }
+// EntityPool implementations
+void EntityPool::add(const WeirdEntity& entity) {
+    positionX.push_back(entity.position.x);
+    positionY.push_back(entity.position.y);
+    positionZ.push_back(entity.position.z);
+    velocityX.push_back(entity.velocity.x);
+    velocityY.push_back(entity.velocity.y);
+    velocityZ.push_back(entity.velocity.z);
+    sizeX.push_back(entity.size.x);
+    sizeY.push_back(entity.size.y);
+    sizeZ.push_back(entity.size.z);
+    rotation.push_back(entity.rotation);
+    rotationSpeed.push_back(entity.rotationSpeed);
+    life.push_back(entity.life);
+    maxLife.push_back(entity.maxLife);
+    morphTime.push_back(entity.morphTime);
+    type.push_back(entity.type);
+    palettes.push_back(entity.colors);
 }
 
-void WeirdEntity::generatePolyhedronTriangles(std::vector<Triangle3D>& triangles, float lifeFactor) const {
-    // Create weird polyhedron with morphing vertices
-    std::vector<Vec3> vertices;
+WeirdEntity EntityPool::get(size_t i) const {
+    WeirdEntity entity;
+    entity.position = Vec3(positionX[i], positionY[i], positionZ[i]);
+    entity.velocity = Vec3(velocityX[i], velocityY[i], velocityZ[i]);
+    entity.size = Vec3(sizeX[i], sizeY[i], sizeZ[i]);
+    entity.rotation = rotation[i];
+    entity.rotationSpeed = rotationSpeed[i];
+    entity.life = life[i];
+    entity.maxLife = maxLife[i];
+    entity.colors = palettes[i];
+    entity.type = type[i];
+    entity.morphTime = morphTime[i];
+    return entity;
+}
+
+void EntityPool::update(float deltaTime) {
+    size_t count = size();
+    if (count == 0) return;
     
-    // Generate base vertices of a deformed polyhedron
-    for (int i = 0; i < 8; i++) {
-        float angle = (i / 8.0f) * 2 * M_PI;
-        float radius = size.x * (1.0f + sin(morphTime * 3 + i) * 0.4f);
-        float height = (i % 2 == 0 ? size.z : -size.z) * (1.0f + cos(morphTime * 2 + i) * 0.3f);
-        
-        vertices.push_back(position + Vec3(
-            cos(angle + rotation) * radius,
-            sin(angle + rotation) * radius,
-            height
-        ));
+    // One chaos roll and one morph rate per entity, drawn in a batch
+    chaosRolls.resize(count);
+    morphRates.resize(count);
+    rng.fillFloats(chaosRolls.data(), count, 0, 1);
+    rng.fillFloats(morphRates.data(), count, 1, 3);
+    
+    float* px = positionX.data();
+    float* py = positionY.data();
+    float* pz = positionZ.data();
+    float* vx = velocityX.data();
+    float* vy = velocityY.data();
+    float* vz = velocityZ.data();
+    float* sx = sizeX.data();
+    float* sy = sizeY.data();
+    float* sz = sizeZ.data();
+    float* angle = rotation.data();
+    const float* spin = rotationSpeed.data();
+    float* remaining = life.data();
+    float* morph = morphTime.data();
+    const float* rates = morphRates.data();
+    
+    // Life, morph clock and position with some chaos
+    #pragma omp simd
+    for (size_t i = 0; i < count; i++) {
+        remaining[i] -= deltaTime;
+        morph[i] += deltaTime;
+        px[i] += vx[i] * deltaTime;
+        py[i] += vy[i] * deltaTime;
+        pz[i] += vz[i] * deltaTime;
     }
     
-    // Connect vertices in weird ways
-    std::vector<std::tuple<int, int, int>> faces = {
-        {0, 1, 2}, {2, 3, 4}, {4, 5, 6}, {6, 7, 0},
-        {0, 2, 4}, {4, 6, 0}, {1, 3, 5}, {5, 7, 1},
-        {0, 1, 7}, {1, 2, 3}, {3, 4, 5}, {5, 6, 7}
-    };
+    // Weird physics - entities can bounce, wrap, or teleport. 1% chance per
+    // frame, so this pass only does real work for a few entities.
+    const float* rolls = chaosRolls.data();
+    for (size_t i = 0; i < count; i++) {
+        if (rolls[i] >= 0.01f) continue;
+        switch (randomInt(0, 3)) {
+            case 0: // Bounce
+                vx[i] *= -1.2f;
+                vy[i] *= -1.2f;
+                break;
+            case 1: // Random teleport
+                px[i] = randomFloat(-3, 3);
+                py[i] = randomFloat(-2, 2);
+                break;
+            case 2: { // Speed up
+                float boost = randomFloat(1.5f, 2.0f);
+                vx[i] *= boost;
+                vy[i] *= boost;
+                vz[i] *= boost;
+                break;
+            }
+            case 3: // Change direction
+                vx[i] = randomFloat(-3, 3);
+                vy[i] = randomFloat(-3, 3);
+                vz[i] = randomFloat(-1, 1);
+                break;
+        }
+    }
     
-    for (auto& face : faces) {
-        int i1 = std::get<0>(face);
-        int i2 = std::get<1>(face);
-        int i3 = std::get<2>(face);
+    // Wrap around screen, spin and morph size
+    #pragma omp simd
+    for (size_t i = 0; i < count; i++) {
+        px[i] = px[i] > 4.0f ? -4.0f : px[i];
+        px[i] = px[i] < -4.0f ? 4.0f : px[i];
+        py[i] = py[i] > 3.0f ? -3.0f : py[i];
+        py[i] = py[i] < -3.0f ? 3.0f : py[i];
+        
+        angle[i] += spin[i] * deltaTime;
         
-        triangles.push_back(Triangle3D(
-            vertices[i1], vertices[i2], vertices[i3],
-            colors[i1 % colors.size()], 
-            colors[i2 % colors.size()], 
-            colors[i3 % colors.size()]
-        ));
+        float morphFactor = fastSin(morph[i] * rates[i]) * 0.3f + 1.0f;
+        sx[i] *= morphFactor;
+        sy[i] *= morphFactor;
+        sz[i] *= morphFactor;
+    }
+    
+    removeDead();
+}
+
+// Swap-remove: the last live entity fills each hole
+void EntityPool::removeDead() {
+    size_t i = 0;
+    while (i < life.size()) {
+        if (life[i] > 0) {
+            i++;
+            continue;
+        }
+        size_t last = life.size() - 1;
+        positionX[i] = positionX[last]; positionX.pop_back();
+        positionY[i] = positionY[last]; positionY.pop_back();
+        positionZ[i] = positionZ[last]; positionZ.pop_back();
+        velocityX[i] = velocityX[last]; velocityX.pop_back();
+        velocityY[i] = velocityY[last]; velocityY.pop_back();
+        velocityZ[i] = velocityZ[last]; velocityZ.pop_back();
+        sizeX[i] = sizeX[last]; sizeX.pop_back();
+        sizeY[i] = sizeY[last]; sizeY.pop_back();
+        sizeZ[i] = sizeZ[last]; sizeZ.pop_back();
+        rotation[i] = rotation[last]; rotation.pop_back();
+        rotationSpeed[i] = rotationSpeed[last]; rotationSpeed.pop_back();
+        maxLife[i] = maxLife[last]; maxLife.pop_back();
+        morphTime[i] = morphTime[last]; morphTime.pop_back();
+        type[i] = type[last]; type.pop_back();
+        palettes[i] = palettes[last]; palettes.pop_back();
+        life[i] = life[last]; life.pop_back();   // i is checked again: the moved entity may be dead too
     }
 }
 
 // WeirdVisualManager implementations
-WeirdVisualManager::WeirdVisualManager() : spawnTimer(0), spawnInterval(randomFloat(0.5f, 2.0f)), maxEntities(randomInt(8, 20)) {}
+WeirdVisualManager::WeirdVisualManager() : spawnTimer(0), spawnInterval(randomFloat(0.5f, 2.0f)), maxEntities(randomInt(8, 20)),
+    populationScale(1) {}
 
 void WeirdVisualManager::update(float deltaTime) {
-    // Update existing entities
-    for (auto& entity : entities) {
-        entity->update(deltaTime, 800, 600);
-    }
-    
-    // Remove dead entities
-    entities.erase(
-        std::remove_if(entities.begin(), entities.end(),
-            [](const std::unique_ptr<WeirdEntity>& entity) {
-                return entity->isDead();
-            }),
-        entities.end()
-    );
+    // Update existing entities and drop the dead ones
+    entities.update(deltaTime);
     
     // Spawn new entities
     spawnTimer += deltaTime;
-    if (spawnTimer >= spawnInterval && entities.size() < maxEntities) {
+    if (spawnTimer >= spawnInterval && entities.size() < (size_t)maxEntities * populationScale) {
         spawnTimer = 0;
         spawnInterval = randomFloat(0.3f, 2.5f); // Random spawn intervals
         
-        Vec3 spawnPos = Vec3(
-            randomFloat(-3, 3),
-            randomFloat(-2, 2),
-            randomFloat(-6, -2)
-        );
-        
-        entities.push_back(std::make_unique<WeirdEntity>(spawnPos));
+        for (int i = 0; i < populationScale; i++) {
+            Vec3 spawnPos = Vec3(
+                randomFloat(-3, 3),
+                randomFloat(-2, 2),
+                randomFloat(-6, -2)
+            );
+            entities.add(WeirdEntity(spawnPos));
+        }
     }
     
     // Occasionally change max entities for chaos
@@ -326,15 +577,51 @@ void WeirdVisualManager::update(float deltaTime) {
     }
 }
 
-std::vector<Triangle3D> WeirdVisualManager::getAllTriangles() const {
-    std::vector<Triangle3D> allTriangles;
+void WeirdVisualManager::setPopulationScale(int scale) {
+    populationScale = std::max(1, scale);
+}
+
+MeshSpan WeirdVisualManager::getMesh() {
+    // Exclusive prefix sums of the per-entity vertex and triangle counts
+    size_t entityCount = entities.size();
+    vertexOffsets.resize(entityCount + 1);
+    triangleOffsets.resize(entityCount + 1);
+    vertexOffsets[0] = 0;
+    triangleOffsets[0] = 0;
+    for (size_t i = 0; i < entityCount; i++) {
+        WeirdEntity entity = entities.get(i);
+        vertexOffsets[i + 1] = vertexOffsets[i] + entity.getVertexCount();
+        triangleOffsets[i + 1] = triangleOffsets[i] + entity.getTriangleCount();
+    }
+    size_t vertexCount = vertexOffsets[entityCount];
+    size_t triangleCount = triangleOffsets[entityCount];
+    // resize keeps the capacity, so no reallocation once warm
+    vertexArena.resize(vertexCount);
+    triangleArena.resize(triangleCount);
     
-    for (const auto& entity : entities) {
-        auto entityTriangles = entity->generateTriangles();
-        allTriangles.insert(allTriangles.end(), entityTriangles.begin(), entityTriangles.end());
+    // Cut the entities into runs of about kTrianglesPerJob triangles; the
+    // pool hands runs out dynamically, which evens out the mix of types
+    constexpr size_t kTrianglesPerJob = 2048;
+    jobStarts.clear();
+    for (size_t i = 0; i < entityCount; i++) {
+        if (jobStarts.empty() || triangleOffsets[i] - triangleOffsets[jobStarts.back()] >= kTrianglesPerJob) {
+            jobStarts.push_back(i);
+        }
     }
+    size_t jobCount = jobStarts.size();
+    jobStarts.push_back(entityCount);
+    
+    // The body only captures this, which keeps it inside std::function's
+    // small buffer, so handing it to the pool does not allocate
+    globalThreadPool().parallelFor(jobCount, [this](size_t job, size_t) {
+        for (size_t i = jobStarts[job]; i < jobStarts[job + 1]; i++) {
+            entities.get(i).generateMesh(vertexArena.data() + vertexOffsets[i],
+                                         triangleArena.data() + triangleOffsets[i],
+                                         (uint32_t)vertexOffsets[i]);
+        }
+    });
     
-    return allTriangles;
+    return { vertexArena.data(), vertexCount, triangleArena.data(), triangleCount };
 }
 
 size_t WeirdVisualManager::getEntityCount() const {
@@ -1,13 +1,30 @@
 #pragma once
 
 #include <vector>
-#include <memory>
 #include "utils.h"
 
-// Forward declaration
-class Triangle3D;
+// Non-owning view of a frame's indexed mesh (see WeirdVisualManager::getMesh):
+// triangles index into vertices
+struct MeshSpan {
+    const Vec3* vertices;
+    size_t vertexCount;
+    const IndexedTriangle* triangles;
+    size_t triangleCount;
+};
+
+// Entity color palette, stored inline: 3 to kCapacity colors
+struct EntityPalette {
+    static constexpr int kCapacity = 6;
+    uint32_t entries[kCapacity];
+    int count;
+    
+    size_t size() const { return count; }
+    uint32_t operator[](size_t i) const { return entries[i]; }
+};
 
-// Weird Visual Entity class
+// One weird visual entity, by value. The live ones are kept in an
+// EntityPool; this is what spawning produces and what triangle generation
+// reads, gathered from the pool.
 struct WeirdEntity {
     Vec3 position;
     Vec3 velocity;
@@ -16,39 +33,88 @@ struct WeirdEntity {
     float rotationSpeed;
     float life;
     float maxLife;
-    std::vector<uint32_t> colors;
+    EntityPalette colors;
     int type;
     float morphTime;
     
+    // Random velocity, size, spin, lifetime, type and palette around pos
     WeirdEntity(Vec3 pos);
+    WeirdEntity() = default;   // fields left for the caller (EntityPool::get) to fill
     
-    void update(float deltaTime, int screenWidth, int screenHeight);
-    bool isDead() const;
-    std::vector<Triangle3D> generateTriangles() const;
+    // Number of vertices and triangles generateMesh will write this frame
+    int getVertexCount() const;
+    int getTriangleCount() const;
+    
+    // Writes this frame's mesh: the type's template, built once, with this
+    // frame's vertex positions. Fills exactly getVertexCount() vertices and
+    // getTriangleCount() triangles, with vertex indices offset by
+    // firstVertex (where vertices sits in the frame's vertex buffer). Pure:
+    // reads only this entity, so any number of entities can be generated
+    // concurrently.
+    void generateMesh(Vec3* vertices, IndexedTriangle* triangles, uint32_t firstVertex) const;
+};
 
+// Live entities as parallel arrays, one per field, so update() is a plain
+// sweep over floats that vectorizes. Dead entities are swap-removed: the
+// last entity moves into the hole, so storage never shrinks and a pool that
+// has reached its peak population never allocates again. Order is not kept.
+class EntityPool {
+public:
+    size_t size() const { return life.size(); }
+    bool empty() const { return life.empty(); }
+    
+    void add(const WeirdEntity& entity);
+    WeirdEntity get(size_t i) const;
+    
+    // Motion, random kicks, screen wrap, spin and morphing for every entity,
+    // then removal of the ones whose life ran out
+    void update(float deltaTime);
+    
 private:
-    void generateSpikyTriangles(std::vector<Triangle3D>& triangles, float lifeFactor) const;
-    void generateBlobTriangles(std::vector<Triangle3D>& triangles, float lifeFactor) const;
-    void generateFractalTriangles(std::vector<Triangle3D>& triangles, float lifeFactor) const;
-    void generateFractalLevel(std::vector<Triangle3D>& triangles, Vec3 center, float scale, int level, int maxLevel) const;
-    void generateRibbonTriangles(std::vector<Triangle3D>& triangles, float lifeFactor) const;
-    void generateOrbTriangles(std::vector<Triangle3D>& triangles, float lifeFactor) const;
-    void generateFragmentTriangles(std::vector<Triangle3D>& triangles, float lifeFactor) const;
-    void generatePolyhedronTriangles(std::vector<Triangle3D>& triangles, float lifeFactor) const;
+    void removeDead();
+    
+    std::vector<float> positionX, positionY, positionZ;
+    std::vector<float> velocityX, velocityY, velocityZ;
+    std::vector<float> sizeX, sizeY, sizeZ;
+    std::vector<float> rotation, rotationSpeed;
+    std::vector<float> life, maxLife, morphTime;
+    std::vector<int> type;
+    std::vector<EntityPalette> palettes;
+    
+    // Random draws for a sweep, made up front in one batch
+    std::vector<float> chaosRolls, morphRates;
 };
 
 // Weird Visual Manager
 class WeirdVisualManager {
 private:
-    std::vector<std::unique_ptr<WeirdEntity>> entities;
+    EntityPool entities;
     float spawnTimer;
     float spawnInterval;
     int maxEntities;
+    int populationScale;
+    std::vector<Vec3> vertexArena;              // refilled every frame, capacity kept
+    std::vector<IndexedTriangle> triangleArena;
+    std::vector<size_t> vertexOffsets;          // entity i writes [offsets[i], offsets[i + 1])
+    std::vector<size_t> triangleOffsets;
+    std::vector<size_t> jobStarts;              // first entity of each generation job
     
 public:
     WeirdVisualManager();
     
     void update(float deltaTime);
-    std::vector<Triangle3D> getAllTriangles() const;
+    
+    // Every entity's mesh for this frame as one indexed mesh, generated into
+    // reused arenas: once they have grown to the peak counts no frame
+    // allocates. The span is valid until the next call. Prefix sums over the
+    // per-entity counts give every entity disjoint slices, and runs of
+    // entities are filled in parallel on globalThreadPool(); the output is
+    // the same for any thread count.
+    MeshSpan getMesh();
     size_t getEntityCount() const;
-};
\ No newline at end of file
+    
+    // Multiplies the population: the entity cap (normally 5 to 25) and the
+    // number of entities spawned per spawn tick
+    void setPopulationScale(int scale);
+    int getPopulationScale() const { return populationScale; }
+};